@@ -24,6 +24,7 @@
 #include "wine/debug.h"
 
 #include "d3dcompiler_private.h"
+#include "wine/d3dcompiler.h"
 
 WINE_DEFAULT_DEBUG_CHANNEL(d3dcompiler);
 
@@ -649,6 +650,238 @@ HRESULT WINAPI D3DCompile(const void *data, SIZE_T data_size, const char *filena
             eflags, 0, NULL, 0, shader, error_messages);
 }
 
+/* Include handler shared by all the jobs of a batch. Every include file is
+ * opened once through the application's handler, and the same data pointer is
+ * handed out to all jobs. Since nested includes are looked up by parent data,
+ * keeping the pointers stable also keeps nested lookups hitting the cache. */
+struct d3dcompiler_cached_include
+{
+    struct list entry;
+    D3D_INCLUDE_TYPE type;
+    const void *parent_data;
+    char *filename;
+    const void *data;
+    UINT size;
+};
+
+struct d3dcompiler_include_cache
+{
+    ID3DInclude ID3DInclude_iface;
+    ID3DInclude *include;
+    CRITICAL_SECTION cs;
+    struct list includes;
+};
+
+static inline struct d3dcompiler_include_cache *impl_from_include_cache(ID3DInclude *iface)
+{
+    return CONTAINING_RECORD(iface, struct d3dcompiler_include_cache, ID3DInclude_iface);
+}
+
+static HRESULT WINAPI d3dcompiler_include_cache_open(ID3DInclude *iface, D3D_INCLUDE_TYPE include_type,
+        const char *filename, const void *parent_data, const void **data, UINT *bytes)
+{
+    struct d3dcompiler_include_cache *cache = impl_from_include_cache(iface);
+    struct d3dcompiler_cached_include *cached;
+    HRESULT hr;
+
+    EnterCriticalSection(&cache->cs);
+
+    LIST_FOR_EACH_ENTRY(cached, &cache->includes, struct d3dcompiler_cached_include, entry)
+    {
+        if (cached->type == include_type && cached->parent_data == parent_data
+                && !strcmp(cached->filename, filename))
+        {
+            *data = cached->data;
+            *bytes = cached->size;
+            LeaveCriticalSection(&cache->cs);
+            return S_OK;
+        }
+    }
+
+    if (!(cached = malloc(sizeof(*cached))) || !(cached->filename = strdup(filename)))
+    {
+        free(cached);
+        LeaveCriticalSection(&cache->cs);
+        return E_OUTOFMEMORY;
+    }
+
+    if (FAILED(hr = ID3DInclude_Open(cache->include, include_type, filename, parent_data,
+            &cached->data, &cached->size)))
+    {
+        free(cached->filename);
+        free(cached);
+        LeaveCriticalSection(&cache->cs);
+        return hr;
+    }
+
+    cached->type = include_type;
+    cached->parent_data = parent_data;
+    list_add_tail(&cache->includes, &cached->entry);
+
+    *data = cached->data;
+    *bytes = cached->size;
+
+    LeaveCriticalSection(&cache->cs);
+    return S_OK;
+}
+
+static HRESULT WINAPI d3dcompiler_include_cache_close(ID3DInclude *iface, const void *data)
+{
+    /* Cached data is released when the batch completes. */
+    return S_OK;
+}
+
+static const struct ID3DIncludeVtbl d3dcompiler_include_cache_vtbl =
+{
+    d3dcompiler_include_cache_open,
+    d3dcompiler_include_cache_close
+};
+
+static void d3dcompiler_include_cache_init(struct d3dcompiler_include_cache *cache, ID3DInclude *include)
+{
+    cache->ID3DInclude_iface.lpVtbl = &d3dcompiler_include_cache_vtbl;
+    cache->include = include;
+    InitializeCriticalSectionEx(&cache->cs, 0, RTL_CRITICAL_SECTION_FLAG_FORCE_DEBUG_INFO);
+    cache->cs.DebugInfo->Spare[0] = (DWORD_PTR)(__FILE__ ": d3dcompiler_include_cache.cs");
+    list_init(&cache->includes);
+}
+
+static void d3dcompiler_include_cache_cleanup(struct d3dcompiler_include_cache *cache)
+{
+    struct d3dcompiler_cached_include *cached, *next;
+
+    /* Close in reverse order, so that nested includes are released before
+     * the files including them. */
+    LIST_FOR_EACH_ENTRY_SAFE_REV(cached, next, &cache->includes, struct d3dcompiler_cached_include, entry)
+    {
+        ID3DInclude_Close(cache->include, cached->data);
+        free(cached->filename);
+        free(cached);
+    }
+
+    cache->cs.DebugInfo->Spare[0] = 0;
+    DeleteCriticalSection(&cache->cs);
+}
+
+struct d3dcompiler_batch
+{
+    const void *data;
+    SIZE_T data_size;
+    const char *filename;
+    ID3DInclude *include;
+    struct wine_d3d_compile_job *jobs;
+    UINT job_count;
+    LONG next_job;
+    LONG pending_workers;
+    HANDLE done_event;
+};
+
+static void d3dcompiler_batch_run(struct d3dcompiler_batch *batch)
+{
+    struct wine_d3d_compile_job *job;
+    unsigned int i;
+
+    while ((i = InterlockedIncrement(&batch->next_job) - 1) < batch->job_count)
+    {
+        job = &batch->jobs[i];
+        job->hr = D3DCompile2(batch->data, batch->data_size, batch->filename, job->defines,
+                batch->include, job->entry_point, job->target, job->flags1, job->flags2,
+                0, NULL, 0, &job->shader, &job->error_messages);
+    }
+
+    if (!InterlockedDecrement(&batch->pending_workers) && batch->done_event)
+        SetEvent(batch->done_event);
+}
+
+static void CALLBACK d3dcompiler_batch_worker(TP_CALLBACK_INSTANCE *instance, void *context)
+{
+    d3dcompiler_batch_run(context);
+}
+
+/* Compile several permutations of the same source. The jobs are spread over
+ * the thread pool, with the calling thread taking part as well, and include
+ * files are only loaded once for the whole batch. */
+HRESULT WINAPI wine_D3DCompileBatch(const void *data, SIZE_T data_size, const char *filename,
+        ID3DInclude *include, struct wine_d3d_compile_job *jobs, UINT job_count)
+{
+    struct d3dcompiler_include_from_file include_from_file;
+    struct d3dcompiler_include_cache include_cache;
+    struct d3dcompiler_batch batch;
+    unsigned int worker_count, i;
+    SYSTEM_INFO system_info;
+    HRESULT hr = S_OK;
+
+    TRACE("data %p, data_size %Iu, filename %s, include %p, jobs %p, job_count %u.\n",
+            data, data_size, debugstr_a(filename), include, jobs, job_count);
+
+    if (!jobs && job_count)
+        return E_INVALIDARG;
+
+    for (i = 0; i < job_count; ++i)
+    {
+        jobs[i].shader = NULL;
+        jobs[i].error_messages = NULL;
+        jobs[i].hr = E_FAIL;
+    }
+    if (!job_count)
+        return S_OK;
+
+    if (include == D3D_COMPILE_STANDARD_FILE_INCLUDE)
+    {
+        include_from_file.ID3DInclude_iface.lpVtbl = &d3dcompiler_include_from_file_vtbl;
+        include_from_file.initial_filename = filename ? filename : "";
+        include = &include_from_file.ID3DInclude_iface;
+    }
+    if (include)
+        d3dcompiler_include_cache_init(&include_cache, include);
+
+    batch.data = data;
+    batch.data_size = data_size;
+    batch.filename = filename;
+    batch.include = include ? &include_cache.ID3DInclude_iface : NULL;
+    batch.jobs = jobs;
+    batch.job_count = job_count;
+    batch.next_job = 0;
+
+    GetSystemInfo(&system_info);
+    worker_count = min(job_count, max(system_info.dwNumberOfProcessors, 1));
+    batch.pending_workers = worker_count;
+    batch.done_event = NULL;
+    if (worker_count > 1 && !(batch.done_event = CreateEventW(NULL, TRUE, FALSE, NULL)))
+        batch.pending_workers = worker_count = 1;
+
+    for (i = 1; i < worker_count; ++i)
+    {
+        if (!TrySubmitThreadpoolCallback(d3dcompiler_batch_worker, &batch, NULL))
+        {
+            WARN("Failed to submit thread pool callback, error %lu.\n", GetLastError());
+            InterlockedDecrement(&batch.pending_workers);
+        }
+    }
+
+    d3dcompiler_batch_run(&batch);
+
+    if (batch.done_event)
+    {
+        WaitForSingleObject(batch.done_event, INFINITE);
+        CloseHandle(batch.done_event);
+    }
+
+    if (include)
+        d3dcompiler_include_cache_cleanup(&include_cache);
+
+    for (i = 0; i < job_count; ++i)
+    {
+        if (FAILED(jobs[i].hr))
+        {
+            hr = jobs[i].hr;
+            break;
+        }
+    }
+
+    return hr;
+}
+
 HRESULT WINAPI D3DPreprocess(const void *data, SIZE_T size, const char *filename,
         const D3D_SHADER_MACRO *defines, ID3DInclude *include,
         ID3DBlob **shader, ID3DBlob **error_messages)
@@ -15,3 +15,6 @@
 @ stdcall D3DReflect(ptr long ptr ptr)
 @ stub D3DReturnFailure1
 @ stdcall D3DStripShader(ptr long long ptr)
+
+# Wine extensions
+@ stdcall wine_D3DCompileBatch(ptr long str ptr ptr long)
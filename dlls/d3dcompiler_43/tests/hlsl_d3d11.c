@@ -22,6 +22,7 @@
 #define COBJMACROS
 #include "d3dcompiler.h"
 #include "d3d11.h"
+#include "wine/d3dcompiler.h"
 #include "wine/test.h"
 
 static HRESULT (WINAPI *pD3D11CreateDevice)(IDXGIAdapter *adapter, D3D_DRIVER_TYPE driver_type,
@@ -1162,12 +1163,126 @@ static void test_semantic_reflection(void)
     }
 }
 
+struct batch_include
+{
+    ID3DInclude ID3DInclude_iface;
+    LONG open_count;
+    LONG close_count;
+};
+
+static HRESULT WINAPI batch_include_Open(ID3DInclude *iface, D3D_INCLUDE_TYPE type,
+        const char *filename, const void *parent_data, const void **data, UINT *bytes)
+{
+    static const char include_source[] =
+        "float4 get_colour()\n"
+        "{\n"
+        "#ifdef RED\n"
+        "    return float4(1.0, 0.0, 0.0, 1.0);\n"
+        "#else\n"
+        "    return float4(0.0, 0.0, 1.0, 1.0);\n"
+        "#endif\n"
+        "}\n";
+    struct batch_include *include = CONTAINING_RECORD(iface, struct batch_include, ID3DInclude_iface);
+
+    ok(!strcmp(filename, "colour.h"), "Got unexpected filename %s.\n", debugstr_a(filename));
+    InterlockedIncrement(&include->open_count);
+    *data = include_source;
+    *bytes = strlen(include_source);
+    return S_OK;
+}
+
+static HRESULT WINAPI batch_include_Close(ID3DInclude *iface, const void *data)
+{
+    struct batch_include *include = CONTAINING_RECORD(iface, struct batch_include, ID3DInclude_iface);
+
+    InterlockedIncrement(&include->close_count);
+    return S_OK;
+}
+
+static const struct ID3DIncludeVtbl batch_include_vtbl =
+{
+    batch_include_Open,
+    batch_include_Close,
+};
+
+static void test_compile_batch(void)
+{
+    static const char source[] =
+        "#include \"colour.h\"\n"
+        "float4 main() : sv_target\n"
+        "{\n"
+        "    return get_colour() * SCALE;\n"
+        "}\n";
+    static const D3D_SHADER_MACRO red_defines[] = {{"RED", "1"}, {"SCALE", "0.5"}, {NULL, NULL}};
+    static const D3D_SHADER_MACRO blue_defines[] = {{"SCALE", "2.0"}, {NULL, NULL}};
+    static const D3D_SHADER_MACRO bad_defines[] = {{"SCALE", "undefined_identifier"}, {NULL, NULL}};
+    struct batch_include include = {{&batch_include_vtbl}};
+    struct wine_d3d_compile_job jobs[9];
+    pwine_D3DCompileBatch pwine_D3DCompileBatch;
+    char buffer[20];
+    unsigned int i;
+    HRESULT hr;
+
+    sprintf(buffer, "d3dcompiler_%d", D3D_COMPILER_VERSION);
+    pwine_D3DCompileBatch = (void *)GetProcAddress(GetModuleHandleA(buffer), "wine_D3DCompileBatch");
+    if (!pwine_D3DCompileBatch)
+    {
+        win_skip("wine_D3DCompileBatch() is not available.\n");
+        return;
+    }
+
+    hr = pwine_D3DCompileBatch(source, strlen(source), NULL, &include.ID3DInclude_iface, NULL, 0);
+    ok(hr == S_OK, "Got unexpected hr %#lx.\n", hr);
+
+    memset(jobs, 0, sizeof(jobs));
+    for (i = 0; i < ARRAY_SIZE(jobs); ++i)
+    {
+        jobs[i].defines = i % 2 ? blue_defines : red_defines;
+        jobs[i].entry_point = "main";
+        jobs[i].target = "ps_4_0";
+    }
+    hr = pwine_D3DCompileBatch(source, strlen(source), NULL, &include.ID3DInclude_iface, jobs, ARRAY_SIZE(jobs));
+    ok(hr == S_OK, "Got unexpected hr %#lx.\n", hr);
+    ok(include.open_count == 1, "Got unexpected open count %lu.\n", include.open_count);
+    ok(include.close_count == 1, "Got unexpected close count %lu.\n", include.close_count);
+    for (i = 0; i < ARRAY_SIZE(jobs); ++i)
+    {
+        winetest_push_context("Job %u", i);
+        ok(jobs[i].hr == S_OK, "Got unexpected hr %#lx.\n", jobs[i].hr);
+        ok(!!jobs[i].shader, "Expected a shader blob.\n");
+        if (jobs[i].shader)
+            ID3D10Blob_Release(jobs[i].shader);
+        if (jobs[i].error_messages)
+            ID3D10Blob_Release(jobs[i].error_messages);
+        winetest_pop_context();
+    }
+
+    jobs[1].defines = bad_defines;
+    hr = pwine_D3DCompileBatch(source, strlen(source), NULL, &include.ID3DInclude_iface, jobs, 2);
+    ok(hr == E_FAIL, "Got unexpected hr %#lx.\n", hr);
+    ok(jobs[0].hr == S_OK, "Got unexpected hr %#lx.\n", jobs[0].hr);
+    ok(!!jobs[0].shader, "Expected a shader blob.\n");
+    ok(jobs[1].hr == E_FAIL, "Got unexpected hr %#lx.\n", jobs[1].hr);
+    ok(!jobs[1].shader, "Got unexpected shader blob %p.\n", jobs[1].shader);
+    ok(!!jobs[1].error_messages, "Expected an error messages blob.\n");
+    ok(include.open_count == 2, "Got unexpected open count %lu.\n", include.open_count);
+    ok(include.close_count == 2, "Got unexpected close count %lu.\n", include.close_count);
+    for (i = 0; i < 2; ++i)
+    {
+        if (jobs[i].shader)
+            ID3D10Blob_Release(jobs[i].shader);
+        if (jobs[i].error_messages)
+            ID3D10Blob_Release(jobs[i].error_messages);
+    }
+}
+
 START_TEST(hlsl_d3d11)
 {
     HMODULE mod;
 
     test_reflection();
     test_semantic_reflection();
+    test_compile_batch();
 
     if (!(mod = LoadLibraryA("d3d11.dll")))
     {
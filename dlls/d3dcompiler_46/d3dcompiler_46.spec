@@ -23,3 +23,6 @@
 @ stdcall D3DStripShader(ptr long long ptr)
 @ stdcall D3DWriteBlobToFile(ptr wstr long)
 @ stub DebugSetMute
+
+# Wine extensions
+@ stdcall wine_D3DCompileBatch(ptr long str ptr ptr long)
@@ -1211,6 +1211,155 @@ static int __cdecl compare_vertex_keys(const void *a, const void *b)
     return left->key < right->key ? -1 : 1;
 }
 
+/* A uniform grid, hashed into a fixed number of buckets, used to find the
+ * vertices coincident with a given vertex without scanning all vertices
+ * that happen to have a similar x + y + z. */
+struct vertex_grid
+{
+    float cell_size; /* 0.0f for exact matching. */
+    DWORD bucket_mask;
+    DWORD *buckets;
+    DWORD *next;
+};
+
+#define VERTEX_GRID_CELL_LIMIT (1 << 30)
+
+static int vertex_grid_coordinate(const struct vertex_grid *grid, float value)
+{
+    float cell;
+
+    if (!grid->cell_size)
+    {
+        /* Treat -0.0f and 0.0f as the same position. */
+        if (value == 0.0f)
+            return 0;
+        return *(int *)&value;
+    }
+
+    cell = floorf(value / grid->cell_size);
+    if (!(cell >= -VERTEX_GRID_CELL_LIMIT))
+        return -VERTEX_GRID_CELL_LIMIT;
+    if (cell > VERTEX_GRID_CELL_LIMIT)
+        return VERTEX_GRID_CELL_LIMIT;
+    return cell;
+}
+
+static DWORD vertex_grid_bucket(const struct vertex_grid *grid, int x, int y, int z)
+{
+    return ((x * 73856093u) ^ (y * 19349663u) ^ (z * 83492791u)) & grid->bucket_mask;
+}
+
+static BOOL vertex_grid_init(struct vertex_grid *grid, const BYTE *vertices, DWORD vertex_size,
+        DWORD vertex_count, float epsilon)
+{
+    DWORD bucket_count = 1, i;
+
+    while (bucket_count < 2 * vertex_count)
+        bucket_count <<= 1;
+
+    /* Coincident vertices are at most epsilon apart, so they are always in
+     * the same or neighbouring cells. The cells are made slightly larger
+     * than epsilon to stay clear of rounding issues in the division. */
+    grid->cell_size = epsilon > 0.0f ? epsilon * 1.125f : 0.0f;
+    grid->bucket_mask = bucket_count - 1;
+    if (!(grid->buckets = malloc(bucket_count * sizeof(*grid->buckets))))
+        return FALSE;
+    if (!(grid->next = malloc(vertex_count * sizeof(*grid->next))))
+    {
+        free(grid->buckets);
+        return FALSE;
+    }
+    memset(grid->buckets, 0xff, bucket_count * sizeof(*grid->buckets));
+
+    for (i = 0; i < vertex_count; ++i)
+    {
+        const D3DXVECTOR3 *vertex = (const D3DXVECTOR3 *)(vertices + vertex_size * i);
+        DWORD bucket = vertex_grid_bucket(grid, vertex_grid_coordinate(grid, vertex->x),
+                vertex_grid_coordinate(grid, vertex->y), vertex_grid_coordinate(grid, vertex->z));
+
+        grid->next[i] = grid->buckets[bucket];
+        grid->buckets[bucket] = i;
+    }
+
+    return TRUE;
+}
+
+static void vertex_grid_cleanup(struct vertex_grid *grid)
+{
+    free(grid->buckets);
+    free(grid->next);
+}
+
+static int __cdecl compare_dwords(const void *a, const void *b)
+{
+    DWORD left = *(const DWORD *)a, right = *(const DWORD *)b;
+
+    return left < right ? -1 : left > right;
+}
+
+/* Collects the sorted positions, greater than "position", of all vertices
+ * coincident with "vertex", in ascending order. */
+static BOOL vertex_grid_find_coincident(const struct vertex_grid *grid, const BYTE *vertices, DWORD vertex_size,
+        const D3DXVECTOR3 *vertex, float epsilon, const DWORD *sorted_positions, DWORD position,
+        DWORD **candidates, DWORD *candidates_size, DWORD *candidate_count)
+{
+    int x = vertex_grid_coordinate(grid, vertex->x);
+    int y = vertex_grid_coordinate(grid, vertex->y);
+    int z = vertex_grid_coordinate(grid, vertex->z);
+    int range = grid->cell_size ? 1 : 0;
+    DWORD count = 0, i, j;
+    int dx, dy, dz;
+
+    for (dz = -range; dz <= range; ++dz)
+    {
+        for (dy = -range; dy <= range; ++dy)
+        {
+            for (dx = -range; dx <= range; ++dx)
+            {
+                DWORD idx = grid->buckets[vertex_grid_bucket(grid, x + dx, y + dy, z + dz)];
+
+                for (; idx != ~0u; idx = grid->next[idx])
+                {
+                    const D3DXVECTOR3 *other = (const D3DXVECTOR3 *)(vertices + vertex_size * idx);
+
+                    if (sorted_positions[idx] <= position
+                            || !(fabsf(vertex->x - other->x) <= epsilon)
+                            || !(fabsf(vertex->y - other->y) <= epsilon)
+                            || !(fabsf(vertex->z - other->z) <= epsilon))
+                        continue;
+
+                    if (count == *candidates_size)
+                    {
+                        DWORD new_size = max(16, *candidates_size * 2);
+                        DWORD *new_candidates;
+
+                        if (!(new_candidates = realloc(*candidates, new_size * sizeof(*new_candidates))))
+                            return FALSE;
+                        *candidates = new_candidates;
+                        *candidates_size = new_size;
+                    }
+                    (*candidates)[count++] = sorted_positions[idx];
+                }
+            }
+        }
+    }
+
+    /* Neighbouring cells may hash to the same bucket. */
+    if (count > 1)
+    {
+        qsort(*candidates, count, sizeof(**candidates), compare_dwords);
+        for (i = 1, j = 1; i < count; ++i)
+        {
+            if ((*candidates)[i] != (*candidates)[j - 1])
+                (*candidates)[j++] = (*candidates)[i];
+        }
+        count = j;
+    }
+
+    *candidate_count = count;
+    return TRUE;
+}
+
 static HRESULT WINAPI d3dx9_mesh_GenerateAdjacency(ID3DXMesh *iface, float epsilon, DWORD *adjacency)
 {
     struct d3dx9_mesh *This = impl_from_ID3DXMesh(iface);
@@ -1219,11 +1368,17 @@ static HRESULT WINAPI d3dx9_mesh_GenerateAdjacency(ID3DXMesh *iface, float epsil
     const DWORD *indices = NULL;
     DWORD vertex_size;
     DWORD buffer_size;
-    /* sort the vertices by (x + y + z) to quickly find coincident vertices */
+    /* sort the vertices by (x + y + z); this determines the order in which
+     * pairs of coincident vertices are visited, and thus which faces end up
+     * adjacent when an edge is shared by more than two faces */
     struct vertex_metadata *sorted_vertices;
+    /* position of each vertex in sorted_vertices */
+    DWORD *sorted_positions;
     /* shared_indices links together identical indices in the index buffer so
      * that adjacency checks can be limited to faces sharing a vertex */
     DWORD *shared_indices = NULL;
+    DWORD *candidates = NULL, candidates_size = 0, candidate_count;
+    struct vertex_grid grid = {0};
     const FLOAT epsilon_sq = epsilon * epsilon;
     DWORD i;
 
@@ -1232,13 +1387,15 @@ static HRESULT WINAPI d3dx9_mesh_GenerateAdjacency(ID3DXMesh *iface, float epsil
     if (!adjacency)
         return D3DERR_INVALIDCALL;
 
-    buffer_size = This->numfaces * 3 * sizeof(*shared_indices) + This->numvertices * sizeof(*sorted_vertices);
+    buffer_size = This->numfaces * 3 * sizeof(*shared_indices) + This->numvertices * sizeof(*sorted_vertices)
+            + This->numvertices * sizeof(*sorted_positions);
     if (!(This->options & D3DXMESH_32BIT))
         buffer_size += This->numfaces * 3 * sizeof(*indices);
     shared_indices = malloc(buffer_size);
     if (!shared_indices)
         return E_OUTOFMEMORY;
     sorted_vertices = (struct vertex_metadata*)(shared_indices + This->numfaces * 3);
+    sorted_positions = (DWORD *)(sorted_vertices + This->numvertices);
 
     hr = iface->lpVtbl->LockVertexBuffer(iface, D3DLOCK_READONLY, (void**)&vertices);
     if (FAILED(hr)) goto cleanup;
@@ -1247,7 +1404,7 @@ static HRESULT WINAPI d3dx9_mesh_GenerateAdjacency(ID3DXMesh *iface, float epsil
 
     if (!(This->options & D3DXMESH_32BIT)) {
         const WORD *word_indices = (const WORD*)indices;
-        DWORD *dword_indices = (DWORD*)(sorted_vertices + This->numvertices);
+        DWORD *dword_indices = sorted_positions + This->numvertices;
         indices = dword_indices;
         for (i = 0; i < This->numfaces * 3; i++)
             *dword_indices++ = *word_indices++;
@@ -1267,16 +1424,34 @@ static HRESULT WINAPI d3dx9_mesh_GenerateAdjacency(ID3DXMesh *iface, float epsil
         adjacency[i] = -1;
     }
     qsort(sorted_vertices, This->numvertices, sizeof(*sorted_vertices), compare_vertex_keys);
+    for (i = 0; i < This->numvertices; i++)
+        sorted_positions[sorted_vertices[i].vertex_index] = i;
+
+    if (epsilon >= 0.0f && This->numvertices && !vertex_grid_init(&grid, vertices, vertex_size, This->numvertices, epsilon))
+    {
+        hr = E_OUTOFMEMORY;
+        goto cleanup;
+    }
 
     for (i = 0; i < This->numvertices; i++) {
         struct vertex_metadata *sorted_vertex_a = &sorted_vertices[i];
         D3DXVECTOR3 *vertex_a = (D3DXVECTOR3*)(vertices + sorted_vertex_a->vertex_index * vertex_size);
         DWORD shared_index_a = sorted_vertex_a->first_shared_index;
 
+        if (shared_index_a == -1)
+            continue;
+
+        candidate_count = 0;
+        if (grid.buckets && !vertex_grid_find_coincident(&grid, vertices, vertex_size, vertex_a, epsilon,
+                sorted_positions, i, &candidates, &candidates_size, &candidate_count))
+        {
+            hr = E_OUTOFMEMORY;
+            goto cleanup;
+        }
+
         while (shared_index_a != -1) {
-            DWORD j = i;
+            DWORD j = 0;
             DWORD shared_index_b = shared_indices[shared_index_a];
-            struct vertex_metadata *sorted_vertex_b = sorted_vertex_a;
 
             while (TRUE) {
                 while (shared_index_b != -1) {
@@ -1321,27 +1496,10 @@ static HRESULT WINAPI d3dx9_mesh_GenerateAdjacency(ID3DXMesh *iface, float epsil
 
                     shared_index_b = shared_indices[shared_index_b];
                 }
-                while (++j < This->numvertices) {
-                    D3DXVECTOR3 *vertex_b;
-
-                    sorted_vertex_b++;
-                    if (sorted_vertex_b->key - sorted_vertex_a->key > epsilon * 3.0f) {
-                        /* no more coincident vertices to try */
-                        j = This->numvertices;
-                        break;
-                    }
-                    /* check for coincidence */
-                    vertex_b = (D3DXVECTOR3*)(vertices + sorted_vertex_b->vertex_index * vertex_size);
-                    if (fabsf(vertex_a->x - vertex_b->x) <= epsilon &&
-                        fabsf(vertex_a->y - vertex_b->y) <= epsilon &&
-                        fabsf(vertex_a->z - vertex_b->z) <= epsilon)
-                    {
-                        break;
-                    }
-                }
-                if (j >= This->numvertices)
+                /* continue with the next coincident vertex */
+                if (j >= candidate_count)
                     break;
-                shared_index_b = sorted_vertex_b->first_shared_index;
+                shared_index_b = sorted_vertices[candidates[j++]].first_shared_index;
             }
 
             sorted_vertex_a->first_shared_index = shared_indices[sorted_vertex_a->first_shared_index];
@@ -1353,6 +1511,8 @@ static HRESULT WINAPI d3dx9_mesh_GenerateAdjacency(ID3DXMesh *iface, float epsil
 cleanup:
     if (indices) iface->lpVtbl->UnlockIndexBuffer(iface);
     if (vertices) iface->lpVtbl->UnlockVertexBuffer(iface);
+    vertex_grid_cleanup(&grid);
+    free(candidates);
     free(shared_indices);
     return hr;
 }
@@ -7198,6 +7358,11 @@ HRESULT WINAPI D3DXWeldVertices(ID3DXMesh *mesh, DWORD flags, const D3DXWELDEPSI
 
     if (flags & D3DXWELDEPSILONS_WELDPARTIALMATCHES)
     {
+        FLOAT component_epsilons[MAX_FVF_DECL_SIZE];
+        D3DVERTEXELEMENT9 *decl_ptr;
+        DWORD num_vertex_components;
+        DWORD vertex_size;
+
         hr = mesh->lpVtbl->LockVertexBuffer(mesh, 0, (void**)&vertices);
         if (FAILED(hr))
         {
@@ -7211,30 +7376,30 @@ HRESULT WINAPI D3DXWeldVertices(ID3DXMesh *mesh, DWORD flags, const D3DXWELDEPSI
          * belong to the same attribute group. Otherwise the vertex components
          * that are within epsilon are set to the same value.
          */
+        vertex_size = mesh->lpVtbl->GetNumBytesPerVertex(mesh);
+        for (decl_ptr = This->cached_declaration, num_vertex_components = 0; decl_ptr->Stream != 0xFF; decl_ptr++)
+            component_epsilons[num_vertex_components++] = get_component_epsilon(decl_ptr, epsilons);
+
         for (i = 0; i < 3 * This->numfaces; i++)
         {
-            D3DVERTEXELEMENT9 *decl_ptr;
-            DWORD vertex_size = mesh->lpVtbl->GetNumBytesPerVertex(mesh);
-            DWORD num_vertex_components;
             INT matches = 0;
             BOOL all_match;
             DWORD index = read_ib(indices, indices_are_32bit, i);
+            DWORD c;
 
-            for (decl_ptr = This->cached_declaration, num_vertex_components = 0; decl_ptr->Stream != 0xFF; decl_ptr++, num_vertex_components++)
+            /* Don't weld self */
+            if (index == point_reps[index])
+                matches = num_vertex_components;
+            else
             {
-                BYTE *to = &vertices[vertex_size*index + decl_ptr->Offset];
-                BYTE *from = &vertices[vertex_size*point_reps[index] + decl_ptr->Offset];
-                FLOAT epsilon = get_component_epsilon(decl_ptr, epsilons);
-
-                /* Don't weld self */
-                if (index == point_reps[index])
+                for (c = 0, decl_ptr = This->cached_declaration; c < num_vertex_components; c++, decl_ptr++)
                 {
-                    matches++;
-                    continue;
-                }
+                    BYTE *to = &vertices[vertex_size*index + decl_ptr->Offset];
+                    BYTE *from = &vertices[vertex_size*point_reps[index] + decl_ptr->Offset];
 
-                if (weld_component(to, from, decl_ptr->Type, epsilon))
-                    matches++;
+                    if (weld_component(to, from, decl_ptr->Type, component_epsilons[c]))
+                        matches++;
+                }
             }
 
             all_match = (num_vertex_components == matches);
@@ -2170,6 +2170,146 @@ void copy_pixels(const BYTE *src, UINT src_row_pitch, UINT src_slice_pitch,
     }
 }
 
+/* Whether converting a pixel to its own format is an identity operation, i.e.
+ * the integer conversion path is used and there are no unused bits that
+ * would be cleared. */
+static BOOL format_is_copyable(const struct pixel_format_desc *format)
+{
+    return format->bytes_per_pixel <= 4 && format_types_match(format, format)
+            && format->bits[0] + format->bits[1] + format->bits[2] + format->bits[3] == format->bytes_per_pixel * 8;
+}
+
+/************************************************************
+ * convert_argb_row_fast
+ *
+ * Converts a row of pixels between common formats without going through
+ * get_relevant_argb_components() / make_argb_color() for every pixel.
+ * The results are identical to the generic path. Returns FALSE if there
+ * is no fast path for the given format pair.
+ */
+static BOOL convert_argb_row_fast(const BYTE *src, const struct pixel_format_desc *src_format,
+        BYTE *dst, const struct pixel_format_desc *dst_format, unsigned int width)
+{
+    enum d3dx_pixel_format_id src_id = src_format->format, dst_id = dst_format->format;
+    unsigned int x;
+
+    if (src_id == dst_id && format_is_copyable(src_format))
+    {
+        memcpy(dst, src, width * src_format->bytes_per_pixel);
+        return TRUE;
+    }
+
+    if (src_format->bytes_per_pixel == 4 && dst_format->bytes_per_pixel == 4)
+    {
+        const DWORD *s = (const DWORD *)src;
+        DWORD *d = (DWORD *)dst;
+
+        if (src_id == D3DX_PIXEL_FORMAT_B8G8R8A8_UNORM && dst_id == D3DX_PIXEL_FORMAT_B8G8R8X8_UNORM)
+        {
+            for (x = 0; x < width; ++x)
+                d[x] = s[x] & 0x00ffffff;
+            return TRUE;
+        }
+
+        if (src_id == D3DX_PIXEL_FORMAT_B8G8R8X8_UNORM && dst_id == D3DX_PIXEL_FORMAT_B8G8R8A8_UNORM)
+        {
+            for (x = 0; x < width; ++x)
+                d[x] = s[x] | 0xff000000;
+            return TRUE;
+        }
+
+        if ((src_id == D3DX_PIXEL_FORMAT_R8G8B8A8_UNORM && dst_id == D3DX_PIXEL_FORMAT_B8G8R8A8_UNORM)
+                || (src_id == D3DX_PIXEL_FORMAT_B8G8R8A8_UNORM && dst_id == D3DX_PIXEL_FORMAT_R8G8B8A8_UNORM))
+        {
+            for (x = 0; x < width; ++x)
+                d[x] = (s[x] & 0xff00ff00) | ((s[x] & 0x000000ff) << 16) | ((s[x] & 0x00ff0000) >> 16);
+            return TRUE;
+        }
+
+        if (src_id == D3DX_PIXEL_FORMAT_R8G8B8A8_UNORM && dst_id == D3DX_PIXEL_FORMAT_B8G8R8X8_UNORM)
+        {
+            for (x = 0; x < width; ++x)
+                d[x] = (s[x] & 0x0000ff00) | ((s[x] & 0x000000ff) << 16) | ((s[x] & 0x00ff0000) >> 16);
+            return TRUE;
+        }
+
+        return FALSE;
+    }
+
+    if (src_id == D3DX_PIXEL_FORMAT_B5G6R5_UNORM && dst_format->bytes_per_pixel == 4
+            && (dst_id == D3DX_PIXEL_FORMAT_B8G8R8A8_UNORM || dst_id == D3DX_PIXEL_FORMAT_B8G8R8X8_UNORM))
+    {
+        const DWORD alpha = dst_id == D3DX_PIXEL_FORMAT_B8G8R8A8_UNORM ? 0xff000000 : 0;
+        const WORD *s = (const WORD *)src;
+        DWORD *d = (DWORD *)dst;
+
+        for (x = 0; x < width; ++x)
+        {
+            DWORD r = (s[x] >> 11) & 0x1f, g = (s[x] >> 5) & 0x3f, b = s[x] & 0x1f;
+
+            d[x] = alpha | ((r << 3 | r >> 2) << 16) | ((g << 2 | g >> 4) << 8) | (b << 3 | b >> 2);
+        }
+        return TRUE;
+    }
+
+    if (dst_id == D3DX_PIXEL_FORMAT_B5G6R5_UNORM && src_format->bytes_per_pixel == 4
+            && (src_id == D3DX_PIXEL_FORMAT_B8G8R8A8_UNORM || src_id == D3DX_PIXEL_FORMAT_B8G8R8X8_UNORM))
+    {
+        const DWORD *s = (const DWORD *)src;
+        WORD *d = (WORD *)dst;
+
+        for (x = 0; x < width; ++x)
+            d[x] = ((s[x] >> 8) & 0xf800) | ((s[x] >> 5) & 0x07e0) | ((s[x] >> 3) & 0x001f);
+        return TRUE;
+    }
+
+    return FALSE;
+}
+
+static void convert_argb_pixel(const BYTE *src, const struct pixel_format_desc *src_format,
+        BYTE *dst, const struct pixel_format_desc *dst_format, BOOL types_match,
+        const struct argb_conversion_info *conv_info, const struct argb_conversion_info *ck_conv_info,
+        const struct pixel_format_desc *ck_format, D3DCOLOR color_key, const PALETTEENTRY *palette)
+{
+    DWORD channels[4] = {0};
+
+    if (types_match)
+    {
+        DWORD val;
+
+        get_relevant_argb_components(conv_info, src, channels);
+        val = make_argb_color(conv_info, channels);
+
+        if (color_key)
+        {
+            DWORD ck_pixel;
+
+            get_relevant_argb_components(ck_conv_info, src, channels);
+            ck_pixel = make_argb_color(ck_conv_info, channels);
+            if (ck_pixel == color_key)
+                val &= ~conv_info->destmask[0];
+        }
+        memcpy(dst, &val, dst_format->bytes_per_pixel);
+    }
+    else
+    {
+        struct d3dx_color color;
+
+        format_to_d3dx_color(src_format, src, palette, &color);
+
+        if (color_key)
+        {
+            DWORD ck_pixel;
+
+            format_from_d3dx_color(ck_format, &color, (BYTE *)&ck_pixel);
+            if (ck_pixel == color_key)
+                color.value.w = 0.0f;
+        }
+
+        format_from_d3dx_color(dst_format, &color, dst);
+    }
+}
+
 /************************************************************
  * convert_argb_pixels
  *
@@ -2183,9 +2323,9 @@ void convert_argb_pixels(const BYTE *src, UINT src_row_pitch, UINT src_slice_pit
         const PALETTEENTRY *palette)
 {
     struct argb_conversion_info conv_info, ck_conv_info;
-    const struct pixel_format_desc *ck_format;
-    DWORD channels[4];
+    const struct pixel_format_desc *ck_format = NULL;
     UINT min_width, min_height, min_depth;
+    BOOL types_match;
     UINT x, y, z;
 
     TRACE("src %p, src_row_pitch %u, src_slice_pitch %u, src_size %p, src_format %p, dst %p, "
@@ -2193,8 +2333,9 @@ void convert_argb_pixels(const BYTE *src, UINT src_row_pitch, UINT src_slice_pit
             src, src_row_pitch, src_slice_pitch, src_size, src_format, dst, dst_row_pitch, dst_slice_pitch, dst_size,
             dst_format, color_key, palette);
 
-    ZeroMemory(channels, sizeof(channels));
     init_argb_conversion_info(src_format, dst_format, &conv_info);
+    types_match = format_types_match(src_format, dst_format)
+            && src_format->bytes_per_pixel <= 4 && dst_format->bytes_per_pixel <= 4;
 
     min_width = min(src_size->width, dst_size->width);
     min_height = min(src_size->height, dst_size->height);
@@ -2215,48 +2356,19 @@ void convert_argb_pixels(const BYTE *src, UINT src_row_pitch, UINT src_slice_pit
             const BYTE *src_ptr = src_slice_ptr + y * src_row_pitch;
             BYTE *dst_ptr = dst_slice_ptr + y * dst_row_pitch;
 
-            for (x = 0; x < min_width; x++) {
-                if (format_types_match(src_format, dst_format)
-                        && src_format->bytes_per_pixel <= 4 && dst_format->bytes_per_pixel <= 4)
-                {
-                    DWORD val;
-
-                    get_relevant_argb_components(&conv_info, src_ptr, channels);
-                    val = make_argb_color(&conv_info, channels);
-
-                    if (color_key)
-                    {
-                        DWORD ck_pixel;
-
-                        get_relevant_argb_components(&ck_conv_info, src_ptr, channels);
-                        ck_pixel = make_argb_color(&ck_conv_info, channels);
-                        if (ck_pixel == color_key)
-                            val &= ~conv_info.destmask[0];
-                    }
-                    memcpy(dst_ptr, &val, dst_format->bytes_per_pixel);
-                }
-                else
-                {
-                    struct d3dx_color color, tmp;
-
-                    format_to_d3dx_color(src_format, src_ptr, palette, &color);
-                    tmp = color;
-
-                    if (color_key)
-                    {
-                        DWORD ck_pixel;
-
-                        format_from_d3dx_color(ck_format, &tmp, (BYTE *)&ck_pixel);
-                        if (ck_pixel == color_key)
-                            tmp.value.w = 0.0f;
-                    }
+            if (!color_key && convert_argb_row_fast(src_ptr, src_format, dst_ptr, dst_format, min_width))
+            {
+                dst_ptr += min_width * dst_format->bytes_per_pixel;
+            }
+            else
+            {
+                for (x = 0; x < min_width; x++) {
+                    convert_argb_pixel(src_ptr, src_format, dst_ptr, dst_format, types_match,
+                            &conv_info, &ck_conv_info, ck_format, color_key, palette);
 
-                    color = tmp;
-                    format_from_d3dx_color(dst_format, &color, dst_ptr);
+                    src_ptr += src_format->bytes_per_pixel;
+                    dst_ptr += dst_format->bytes_per_pixel;
                 }
-
-                src_ptr += src_format->bytes_per_pixel;
-                dst_ptr += dst_format->bytes_per_pixel;
             }
 
             if (src_size->width < dst_size->width) /* black out remaining pixels */
@@ -2283,8 +2395,9 @@ void point_filter_argb_pixels(const BYTE *src, UINT src_row_pitch, UINT src_slic
         const PALETTEENTRY *palette)
 {
     struct argb_conversion_info conv_info, ck_conv_info;
-    const struct pixel_format_desc *ck_format;
-    DWORD channels[4];
+    const struct pixel_format_desc *ck_format = NULL;
+    UINT *src_x_offsets;
+    BOOL types_match;
     UINT x, y, z;
 
     TRACE("src %p, src_row_pitch %u, src_slice_pitch %u, src_size %p, src_format %p, dst %p, "
@@ -2292,8 +2405,9 @@ void point_filter_argb_pixels(const BYTE *src, UINT src_row_pitch, UINT src_slic
             src, src_row_pitch, src_slice_pitch, src_size, src_format, dst, dst_row_pitch, dst_slice_pitch, dst_size,
             dst_format, color_key, palette);
 
-    ZeroMemory(channels, sizeof(channels));
     init_argb_conversion_info(src_format, dst_format, &conv_info);
+    types_match = format_types_match(src_format, dst_format)
+            && src_format->bytes_per_pixel <= 4 && dst_format->bytes_per_pixel <= 4;
 
     if (color_key)
     {
@@ -2302,6 +2416,13 @@ void point_filter_argb_pixels(const BYTE *src, UINT src_row_pitch, UINT src_slic
         init_argb_conversion_info(src_format, ck_format, &ck_conv_info);
     }
 
+    /* The source column only depends on x; compute it once instead of once per row. */
+    if ((src_x_offsets = malloc(dst_size->width * sizeof(*src_x_offsets))))
+    {
+        for (x = 0; x < dst_size->width; x++)
+            src_x_offsets[x] = (x * src_size->width / dst_size->width) * src_format->bytes_per_pixel;
+    }
+
     for (z = 0; z < dst_size->depth; z++)
     {
         BYTE *dst_slice_ptr = dst + z * dst_slice_pitch;
@@ -2312,49 +2433,151 @@ void point_filter_argb_pixels(const BYTE *src, UINT src_row_pitch, UINT src_slic
             BYTE *dst_ptr = dst_slice_ptr + y * dst_row_pitch;
             const BYTE *src_row_ptr = src_slice_ptr + src_row_pitch * (y * src_size->height / dst_size->height);
 
+            /* Without stretching in x, whole rows can be converted at once. */
+            if (src_size->width == dst_size->width && !color_key
+                    && convert_argb_row_fast(src_row_ptr, src_format, dst_ptr, dst_format, dst_size->width))
+                continue;
+
             for (x = 0; x < dst_size->width; x++)
             {
-                const BYTE *src_ptr = src_row_ptr + (x * src_size->width / dst_size->width) * src_format->bytes_per_pixel;
+                const BYTE *src_ptr = src_row_ptr + (src_x_offsets ? src_x_offsets[x]
+                        : (x * src_size->width / dst_size->width) * src_format->bytes_per_pixel);
 
-                if (format_types_match(src_format, dst_format)
-                        && src_format->bytes_per_pixel <= 4 && dst_format->bytes_per_pixel <= 4)
-                {
-                    DWORD val;
+                if (!color_key && src_format->format == dst_format->format && format_is_copyable(src_format))
+                    memcpy(dst_ptr, src_ptr, dst_format->bytes_per_pixel);
+                else
+                    convert_argb_pixel(src_ptr, src_format, dst_ptr, dst_format, types_match,
+                            &conv_info, &ck_conv_info, ck_format, color_key, palette);
+
+                dst_ptr += dst_format->bytes_per_pixel;
+            }
+        }
+    }
 
-                    get_relevant_argb_components(&conv_info, src_ptr, channels);
-                    val = make_argb_color(&conv_info, channels);
+    free(src_x_offsets);
+}
 
-                    if (color_key)
-                    {
-                        DWORD ck_pixel;
+/* Whether dst_size is a 2:1 reduction of src_size (per dimension, either
+ * halved or left unchanged), as used for mipmap generation. */
+static BOOL is_box_filter_reduction(const struct volume *src_size, const struct volume *dst_size)
+{
+    return (dst_size->width == src_size->width || dst_size->width == src_size->width / 2)
+            && (dst_size->height == src_size->height || dst_size->height == src_size->height / 2)
+            && (dst_size->depth == src_size->depth || dst_size->depth == src_size->depth / 2)
+            && dst_size->width && dst_size->height && dst_size->depth
+            && (dst_size->width != src_size->width || dst_size->height != src_size->height
+            || dst_size->depth != src_size->depth);
+}
 
-                        get_relevant_argb_components(&ck_conv_info, src_ptr, channels);
-                        ck_pixel = make_argb_color(&ck_conv_info, channels);
-                        if (ck_pixel == color_key)
-                            val &= ~conv_info.destmask[0];
+/************************************************************
+ * box_filter_argb_pixels
+ *
+ * Copies the source buffer to the destination buffer, performing
+ * any necessary format conversion and color keying, averaging each
+ * 2x2(x2) block of source pixels into one destination pixel.
+ * The destination must be a 2:1 reduction of the source.
+ */
+static void box_filter_argb_pixels(const BYTE *src, UINT src_row_pitch, UINT src_slice_pitch,
+        const struct volume *src_size, const struct pixel_format_desc *src_format, BYTE *dst, UINT dst_row_pitch,
+        UINT dst_slice_pitch, const struct volume *dst_size, const struct pixel_format_desc *dst_format,
+        D3DCOLOR color_key, const PALETTEENTRY *palette)
+{
+    const unsigned int x_step = src_size->width == dst_size->width ? 1 : 2;
+    const unsigned int y_step = src_size->height == dst_size->height ? 1 : 2;
+    const unsigned int z_step = src_size->depth == dst_size->depth ? 1 : 2;
+    const unsigned int sample_count = x_step * y_step * z_step;
+    const struct pixel_format_desc *ck_format = NULL;
+    unsigned int x, y, z, i, j, k, c;
+    BOOL integer_path;
+
+    TRACE("src %p, src_row_pitch %u, src_slice_pitch %u, src_size %p, src_format %p, dst %p, "
+            "dst_row_pitch %u, dst_slice_pitch %u, dst_size %p, dst_format %p, color_key 0x%08lx, palette %p.\n",
+            src, src_row_pitch, src_slice_pitch, src_size, src_format, dst, dst_row_pitch, dst_slice_pitch, dst_size,
+            dst_format, color_key, palette);
+
+    /* 8 bits per channel formats can be averaged directly. */
+    integer_path = !color_key && src_format->format == dst_format->format
+            && (src_format->format == D3DX_PIXEL_FORMAT_B8G8R8A8_UNORM
+            || src_format->format == D3DX_PIXEL_FORMAT_B8G8R8X8_UNORM
+            || src_format->format == D3DX_PIXEL_FORMAT_R8G8B8A8_UNORM);
+
+    if (color_key)
+    {
+        /* Color keys are always represented in D3DFMT_A8R8G8B8 format. */
+        ck_format = get_format_info(D3DFMT_A8R8G8B8);
+    }
+
+    for (z = 0; z < dst_size->depth; ++z)
+    {
+        for (y = 0; y < dst_size->height; ++y)
+        {
+            BYTE *dst_ptr = dst + z * dst_slice_pitch + y * dst_row_pitch;
+            const BYTE *src_ptr = src + z * z_step * src_slice_pitch + y * y_step * src_row_pitch;
+
+            for (x = 0; x < dst_size->width; ++x)
+            {
+                if (integer_path)
+                {
+                    unsigned int sums[4] = {0};
+                    DWORD val = 0;
+
+                    for (k = 0; k < z_step; ++k)
+                    {
+                        for (j = 0; j < y_step; ++j)
+                        {
+                            const BYTE *s = src_ptr + k * src_slice_pitch + j * src_row_pitch;
+
+                            for (i = 0; i < x_step; ++i, s += 4)
+                            {
+                                for (c = 0; c < 4; ++c)
+                                    sums[c] += s[c];
+                            }
+                        }
                     }
-                    memcpy(dst_ptr, &val, dst_format->bytes_per_pixel);
+                    for (c = 0; c < 4; ++c)
+                        val |= ((sums[c] + sample_count / 2) / sample_count) << (c * 8);
+                    if (src_format->format == D3DX_PIXEL_FORMAT_B8G8R8X8_UNORM)
+                        val &= 0x00ffffff;
+                    memcpy(dst_ptr, &val, sizeof(val));
                 }
                 else
                 {
-                    struct d3dx_color color, tmp;
-
-                    format_to_d3dx_color(src_format, src_ptr, palette, &color);
-                    tmp = color;
+                    struct d3dx_color color = {0}, sum = {0};
 
-                    if (color_key)
+                    for (k = 0; k < z_step; ++k)
                     {
-                        DWORD ck_pixel;
-
-                        format_from_d3dx_color(ck_format, &tmp, (BYTE *)&ck_pixel);
-                        if (ck_pixel == color_key)
-                            tmp.value.w = 0.0f;
+                        for (j = 0; j < y_step; ++j)
+                        {
+                            const BYTE *s = src_ptr + k * src_slice_pitch + j * src_row_pitch;
+
+                            for (i = 0; i < x_step; ++i, s += src_format->bytes_per_pixel)
+                            {
+                                format_to_d3dx_color(src_format, s, palette, &color);
+                                if (color_key)
+                                {
+                                    DWORD ck_pixel;
+
+                                    format_from_d3dx_color(ck_format, &color, (BYTE *)&ck_pixel);
+                                    if (ck_pixel == color_key)
+                                        color.value.w = 0.0f;
+                                }
+                                sum.value.x += color.value.x;
+                                sum.value.y += color.value.y;
+                                sum.value.z += color.value.z;
+                                sum.value.w += color.value.w;
+                            }
+                        }
                     }
-
-                    color = tmp;
-                    format_from_d3dx_color(dst_format, &color, dst_ptr);
+                    sum.value.x /= sample_count;
+                    sum.value.y /= sample_count;
+                    sum.value.z /= sample_count;
+                    sum.value.w /= sample_count;
+                    sum.rgb_range = color.rgb_range;
+                    sum.a_range = color.a_range;
+                    format_from_d3dx_color(dst_format, &sum, dst_ptr);
                 }
 
+                src_ptr += x_step * src_format->bytes_per_pixel;
                 dst_ptr += dst_format->bytes_per_pixel;
             }
         }
@@ -2633,13 +2856,20 @@ HRESULT d3dx_load_pixels_from_pixels(struct d3dx_pixels *dst_pixels,
                 (BYTE *)dst_pixels->data, dst_pixels->row_pitch, dst_pixels->slice_pitch, &dst_size, dst_desc,
                 color_key, src_pixels->palette);
     }
+    else if ((filter_flags & 0xf) == D3DX_FILTER_BOX && is_box_filter_reduction(&src_size, &dst_size))
+    {
+        box_filter_argb_pixels(src_pixels->data, src_pixels->row_pitch, src_pixels->slice_pitch, &src_size,
+                src_desc, (BYTE *)dst_pixels->data, dst_pixels->row_pitch, dst_pixels->slice_pitch, &dst_size,
+                dst_desc, color_key, src_pixels->palette);
+    }
     else /* if ((filter & 0xf) == D3DX_FILTER_POINT) */
     {
         if ((filter_flags & 0xf) != D3DX_FILTER_POINT)
             FIXME("Unhandled filter %#x.\n", filter_flags);
 
         /* Always apply a point filter until D3DX_FILTER_LINEAR,
-         * D3DX_FILTER_TRIANGLE and D3DX_FILTER_BOX are implemented. */
+         * D3DX_FILTER_TRIANGLE and arbitrary D3DX_FILTER_BOX
+         * reductions are implemented. */
         point_filter_argb_pixels(src_pixels->data, src_pixels->row_pitch, src_pixels->slice_pitch, &src_size,
                 src_desc, (BYTE *)dst_pixels->data, dst_pixels->row_pitch, dst_pixels->slice_pitch, &dst_size,
                 dst_desc, color_key, src_pixels->palette);
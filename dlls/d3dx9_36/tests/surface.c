@@ -2154,6 +2154,71 @@ static void test_load_surface_from_tga(IDirect3DDevice9 *device)
     free(tga);
 }
 
+static void test_box_filter(IDirect3DDevice9 *device)
+{
+    static const uint32_t src_4_4[] =
+    {
+        0x40404040, 0x80808080, 0xff0000fc, 0xff000000,
+        0xc0c0c0c0, 0x00000000, 0xff000000, 0xff000004,
+        0x10203040, 0x10203040, 0x12345678, 0x12345678,
+        0x30405060, 0x30405060, 0x12345678, 0x12345678,
+    };
+    static const uint32_t src_4_1[] = { 0x00000000, 0x80808080, 0xff102030, 0xff304050 };
+    D3DLOCKED_RECT lockrect;
+    IDirect3DSurface9 *surf;
+    RECT rect, dst_rect;
+    HRESULT hr;
+
+    hr = IDirect3DDevice9_CreateOffscreenPlainSurface(device, 2, 2, D3DFMT_A8R8G8B8, D3DPOOL_SCRATCH, &surf, NULL);
+    ok(hr == D3D_OK, "Unexpected hr %#lx.\n", hr);
+
+    /* Each 2x2 block of the source is averaged into one destination pixel. */
+    SetRect(&rect, 0, 0, 4, 4);
+    hr = D3DXLoadSurfaceFromMemory(surf, NULL, NULL, src_4_4, D3DFMT_A8R8G8B8, 16, NULL, &rect, D3DX_FILTER_BOX, 0);
+    ok(hr == D3D_OK, "Unexpected hr %#lx.\n", hr);
+
+    hr = IDirect3DSurface9_LockRect(surf, &lockrect, NULL, D3DLOCK_READONLY);
+    ok(hr == D3D_OK, "Unexpected hr %#lx.\n", hr);
+    check_pixel_4bpp(&lockrect, 0, 0, 0x60606060);
+    check_pixel_4bpp(&lockrect, 1, 0, 0xff000040);
+    check_pixel_4bpp(&lockrect, 0, 1, 0x20304050);
+    check_pixel_4bpp(&lockrect, 1, 1, 0x12345678);
+    hr = IDirect3DSurface9_UnlockRect(surf);
+    ok(hr == D3D_OK, "Unexpected hr %#lx.\n", hr);
+
+    /* Only the width is reduced. */
+    SetRect(&dst_rect, 0, 0, 2, 1);
+    SetRect(&rect, 0, 0, 4, 1);
+    hr = D3DXLoadSurfaceFromMemory(surf, NULL, &dst_rect, src_4_1, D3DFMT_A8R8G8B8, 16, NULL, &rect, D3DX_FILTER_BOX, 0);
+    ok(hr == D3D_OK, "Unexpected hr %#lx.\n", hr);
+
+    hr = IDirect3DSurface9_LockRect(surf, &lockrect, NULL, D3DLOCK_READONLY);
+    ok(hr == D3D_OK, "Unexpected hr %#lx.\n", hr);
+    check_pixel_4bpp(&lockrect, 0, 0, 0x40404040);
+    check_pixel_4bpp(&lockrect, 1, 0, 0xff203040);
+    hr = IDirect3DSurface9_UnlockRect(surf);
+    ok(hr == D3D_OK, "Unexpected hr %#lx.\n", hr);
+    check_release((IUnknown *)surf, 0);
+
+    /* Format conversion while filtering. */
+    hr = IDirect3DDevice9_CreateOffscreenPlainSurface(device, 2, 2, D3DFMT_A8B8G8R8, D3DPOOL_SCRATCH, &surf, NULL);
+    ok(hr == D3D_OK, "Unexpected hr %#lx.\n", hr);
+
+    SetRect(&rect, 0, 0, 4, 4);
+    hr = D3DXLoadSurfaceFromMemory(surf, NULL, NULL, src_4_4, D3DFMT_A8R8G8B8, 16, NULL, &rect, D3DX_FILTER_BOX, 0);
+    ok(hr == D3D_OK, "Unexpected hr %#lx.\n", hr);
+
+    hr = IDirect3DSurface9_LockRect(surf, &lockrect, NULL, D3DLOCK_READONLY);
+    ok(hr == D3D_OK, "Unexpected hr %#lx.\n", hr);
+    check_pixel_4bpp(&lockrect, 0, 0, 0x60606060);
+    check_pixel_4bpp(&lockrect, 1, 0, 0xff400000);
+    check_pixel_4bpp(&lockrect, 0, 1, 0x20504030);
+    check_pixel_4bpp(&lockrect, 1, 1, 0x12785634);
+    hr = IDirect3DSurface9_UnlockRect(surf);
+    ok(hr == D3D_OK, "Unexpected hr %#lx.\n", hr);
+    check_release((IUnknown *)surf, 0);
+}
+
 static void test_D3DXLoadSurface(IDirect3DDevice9 *device)
 {
     HRESULT hr;
@@ -3419,6 +3484,7 @@ static void test_D3DXLoadSurface(IDirect3DDevice9 *device)
     test_format_conversion(device);
     test_dxt_premultiplied_alpha(device);
     test_load_surface_from_tga(device);
+    test_box_filter(device);
 
     /* cleanup */
     if(testdummy_ok) DeleteFileA("testdummy.bmp");
@@ -30,6 +30,11 @@ typedef struct {
     jsdisp_t dispex;
 
     DWORD length;
+
+    /* Elements [0, elems_cnt) are stored here instead of as named properties */
+    jsval_t *elems;
+    DWORD elems_cnt;
+    DWORD elems_size;
 } ArrayInstance;
 
 static inline ArrayInstance *array_from_jsdisp(jsdisp_t *jsdisp)
@@ -49,6 +54,109 @@ unsigned array_get_length(jsdisp_t *array)
     return array_from_jsdisp(array)->length;
 }
 
+static inline BOOL is_dense_array(jsdisp_t *jsdisp)
+{
+    return is_class(jsdisp, JSCLASS_ARRAY) && array_from_jsdisp(jsdisp)->elems_cnt == array_from_jsdisp(jsdisp)->length;
+}
+
+static HRESULT grow_elems(ArrayInstance *array, DWORD size)
+{
+    jsval_t *new_elems;
+    DWORD new_size;
+
+    if(size <= array->elems_size)
+        return S_OK;
+
+    new_size = max(size, array->elems_size < 8 ? 16 : array->elems_size * 2);
+    if(new_size < size || new_size > UINT_MAX / sizeof(*new_elems))
+        return E_OUTOFMEMORY;
+
+    new_elems = realloc(array->elems, new_size * sizeof(*new_elems));
+    if(!new_elems)
+        return E_OUTOFMEMORY;
+
+    array->elems = new_elems;
+    array->elems_size = new_size;
+    return S_OK;
+}
+
+/* Moves elements starting at idx from the element storage to regular properties */
+static HRESULT spill_elems(ArrayInstance *array, DWORD idx)
+{
+    BOOL extensible = array->dispex.extensible;
+    DWORD i, cnt = array->elems_cnt;
+    HRESULT hres = S_OK;
+    WCHAR buf[12];
+
+    array->elems_cnt = idx;
+
+    /* The elements are already own properties, so defining them does not extend the object */
+    array->dispex.extensible = TRUE;
+    for(i = idx; i < cnt; i++) {
+        if(SUCCEEDED(hres)) {
+            swprintf(buf, ARRAY_SIZE(buf), L"%u", i);
+            hres = jsdisp_define_data_property(&array->dispex, buf, PROPF_ENUMERABLE | PROPF_WRITABLE | PROPF_CONFIGURABLE,
+                                               array->elems[i]);
+        }
+        jsval_release(array->elems[i]);
+    }
+    array->dispex.extensible = extensible;
+    return hres;
+}
+
+HRESULT array_get_elem(jsdisp_t *jsdisp, DWORD idx, jsval_t *r)
+{
+    ArrayInstance *array = array_from_jsdisp(jsdisp);
+
+    if(idx >= array->elems_cnt)
+        return S_FALSE;
+    return jsval_copy(array->elems[idx], r);
+}
+
+HRESULT array_set_elem(jsdisp_t *jsdisp, DWORD idx, jsval_t val)
+{
+    ArrayInstance *array = array_from_jsdisp(jsdisp);
+    jsval_t copy, old;
+    HRESULT hres;
+
+    if(idx > array->elems_cnt)
+        return S_FALSE;
+
+    if(idx == array->elems_cnt) {
+        if(!jsdisp->extensible || !jsdisp_claim_index(jsdisp, idx) || FAILED(grow_elems(array, idx + 1)))
+            return S_FALSE;
+    }
+
+    hres = jsval_copy(val, &copy);
+    if(FAILED(hres))
+        return hres;
+
+    if(idx == array->elems_cnt) {
+        array->elems[array->elems_cnt++] = copy;
+        if(array->length < array->elems_cnt)
+            array->length = array->elems_cnt;
+        return S_OK;
+    }
+
+    old = array->elems[idx];
+    array->elems[idx] = copy;
+    jsval_release(old);
+    return S_OK;
+}
+
+HRESULT array_delete_elem(jsdisp_t *jsdisp, DWORD idx)
+{
+    ArrayInstance *array = array_from_jsdisp(jsdisp);
+
+    /* Only removing the last element keeps the storage contiguous */
+    if(!array->elems_cnt || idx != array->elems_cnt - 1)
+        return S_FALSE;
+
+    array->elems_cnt--;
+    jsval_release(array->elems[idx]);
+    return S_OK;
+}
+
 static HRESULT get_length(script_ctx_t *ctx, jsval_t vthis, jsdisp_t **jsthis, UINT32 *ret)
 {
     jsdisp_t *jsdisp;
@@ -133,7 +241,16 @@ static HRESULT Array_set_length(script_ctx_t *ctx, jsdisp_t *jsthis, jsval_t val
     if(len!=(DWORD)len)
         return JS_E_INVALID_LENGTH;
 
-    for(i=len; i < This->length; i++) {
+    i = len;
+    if(i < This->elems_cnt) {
+        DWORD cnt = This->elems_cnt;
+
+        This->elems_cnt = i;
+        for(; i < cnt; i++)
+            jsval_release(This->elems[i]);
+    }
+
+    for(; i < This->length; i++) {
         hres = jsdisp_delete_idx(&This->dispex, i);
         if(FAILED(hres))
             return hres;
@@ -517,6 +634,20 @@ static HRESULT Array_shift(script_ctx_t *ctx, jsval_t vthis, WORD flags, unsigne
         goto done;
     }
 
+    if(is_dense_array(jsthis)) {
+        ArrayInstance *array = array_from_jsdisp(jsthis);
+
+        ret = array->elems[0];
+        memmove(array->elems, array->elems + 1, (length - 1) * sizeof(*array->elems));
+        array->elems_cnt = array->length = length - 1;
+
+        if(r)
+            *r = ret;
+        else
+            jsval_release(ret);
+        goto done;
+    }
+
     hres = jsdisp_get_idx(jsthis, 0, &ret);
     if(hres == DISP_E_UNKNOWNNAME) {
         ret = jsval_undefined();
@@ -827,6 +958,78 @@ done:
     return hres;
 }
 
+static HRESULT splice_dense(script_ctx_t *ctx, ArrayInstance *array, DWORD start, DWORD delete_cnt,
+                            unsigned add_cnt, jsval_t *add, jsdisp_t **ret)
+{
+    DWORD i, length = array->length, new_length = length - delete_cnt + add_cnt;
+    ArrayInstance *ret_array = NULL;
+    jsdisp_t *jsret;
+    HRESULT hres;
+
+    /* Indices the storage starts covering must not be provided by other properties or have
+       setters in the prototype chain, let the generic path handle those. */
+    if(new_length > length) {
+        if(!array->dispex.extensible)
+            return S_FALSE;
+        for(i = length; i < new_length; i++) {
+            if(!jsdisp_claim_index(&array->dispex, i))
+                return S_FALSE;
+        }
+    }
+
+    if(ret) {
+        hres = create_array(ctx, delete_cnt, &jsret);
+        if(FAILED(hres))
+            return hres;
+        ret_array = array_from_jsdisp(jsret);
+        hres = grow_elems(ret_array, delete_cnt);
+        if(SUCCEEDED(hres))
+            hres = grow_elems(array, new_length);
+        if(FAILED(hres)) {
+            jsdisp_release(jsret);
+            return hres;
+        }
+
+        memcpy(ret_array->elems, array->elems + start, delete_cnt * sizeof(*array->elems));
+        ret_array->elems_cnt = delete_cnt;
+    }else {
+        hres = grow_elems(array, new_length);
+        if(FAILED(hres))
+            return hres;
+
+        for(i = start; i < start + delete_cnt; i++) {
+            jsval_t val = array->elems[i];
+            array->elems[i] = jsval_undefined();
+            jsval_release(val);
+        }
+    }
+
+    memmove(array->elems + start + add_cnt, array->elems + start + delete_cnt,
+            (length - start - delete_cnt) * sizeof(*array->elems));
+    for(i = 0; i < add_cnt; i++)
+        array->elems[start + i] = jsval_undefined();
+    array->elems_cnt = array->length = new_length;
+
+    for(i = 0; i < add_cnt; i++) {
+        jsval_t val;
+
+        hres = jsval_copy(add[i], &val);
+        if(FAILED(hres))
+            break;
+        array->elems[start + i] = val;
+    }
+
+    if(FAILED(hres)) {
+        if(ret_array)
+            jsdisp_release(&ret_array->dispex);
+        return hres;
+    }
+
+    if(ret)
+        *ret = &ret_array->dispex;
+    return S_OK;
+}
+
 /* ECMA-262 3rd Edition    15.4.4.12 */
 static HRESULT Array_splice(script_ctx_t *ctx, jsval_t vthis, WORD flags, unsigned argc, jsval_t *argv,
         jsval_t *r)
@@ -876,6 +1079,17 @@ static HRESULT Array_splice(script_ctx_t *ctx, jsval_t vthis, WORD flags, unsign
         delete_cnt = length-start;
     }
 
+    if(is_dense_array(jsthis) && add_args <= UINT_MAX - (length - delete_cnt)) {
+        hres = splice_dense(ctx, array_from_jsdisp(jsthis), start, delete_cnt, add_args,
+                            add_args ? argv + 2 : NULL, r ? &ret_array : NULL);
+        if(hres != S_FALSE) {
+            if(SUCCEEDED(hres) && r)
+                *r = jsval_obj(ret_array);
+            goto done;
+        }
+        hres = S_OK;
+    }
+
     if(r) {
         hres = create_array(ctx, 0, &ret_array);
         if(FAILED(hres))
@@ -1543,6 +1757,15 @@ static HRESULT Array_unshift(script_ctx_t *ctx, jsval_t vthis, WORD flags, unsig
     if(FAILED(hres))
         return hres;
 
+    if(argc && is_dense_array(jsthis) && argc <= UINT_MAX - length) {
+        hres = splice_dense(ctx, array_from_jsdisp(jsthis), 0, 0, argc, argv, NULL);
+        if(hres != S_FALSE) {
+            if(SUCCEEDED(hres) && r)
+                *r = ctx->version < 2 ? jsval_undefined() : jsval_number(length + argc);
+            goto done;
+        }
+    }
+
     if(argc) {
         buf_end = buf + ARRAY_SIZE(buf)-1;
         *buf_end-- = 0;
@@ -1589,6 +1812,150 @@ done:
     return hres;
 }
 
+static void Array_destructor(jsdisp_t *dispex)
+{
+    ArrayInstance *array = array_from_jsdisp(dispex);
+    DWORD i;
+
+    for(i = 0; i < array->elems_cnt; i++)
+        jsval_release(array->elems[i]);
+    free(array->elems);
+}
+
+/* Parses canonical element names. Element storage never gets large enough for longer ones. */
+static BOOL str_to_elem_idx(const WCHAR *name, DWORD *ret)
+{
+    const WCHAR *ptr;
+    DWORD idx = 0;
+
+    if(!is_digit(*name) || (*name == '0' && name[1]))
+        return FALSE;
+
+    for(ptr = name; is_digit(*ptr); ptr++) {
+        if(ptr - name == 9)
+            return FALSE;
+        idx = idx * 10 + (*ptr - '0');
+    }
+    if(*ptr)
+        return FALSE;
+
+    *ret = idx;
+    return TRUE;
+}
+
+static void get_elem_info(DWORD idx, struct property_info *desc)
+{
+    desc->id = idx;
+    desc->flags = PROPF_ENUMERABLE | PROPF_WRITABLE | PROPF_CONFIGURABLE;
+    desc->name = NULL;
+    desc->index = idx;
+    desc->iid = 0;
+}
+
+static HRESULT Array_lookup_prop(jsdisp_t *dispex, const WCHAR *name, unsigned flags, struct property_info *desc)
+{
+    ArrayInstance *array = array_from_jsdisp(dispex);
+    DWORD idx;
+
+    if(!str_to_elem_idx(name, &idx) || idx > array->elems_cnt)
+        return DISP_E_UNKNOWNNAME;
+
+    if(idx == array->elems_cnt) {
+        /* Elements added at the end keep the storage contiguous */
+        if(!(flags & fdexNameEnsure) || !dispex->extensible || FAILED(grow_elems(array, idx + 1)))
+            return DISP_E_UNKNOWNNAME;
+        array->elems[array->elems_cnt++] = jsval_undefined();
+        if(array->length < array->elems_cnt)
+            array->length = array->elems_cnt;
+    }
+
+    get_elem_info(idx, desc);
+    return S_OK;
+}
+
+static HRESULT Array_next_prop(jsdisp_t *dispex, unsigned id, struct property_info *desc)
+{
+    ArrayInstance *array = array_from_jsdisp(dispex);
+
+    if(id + 1 >= array->elems_cnt)
+        return S_FALSE;
+
+    get_elem_info(id + 1, desc);
+    return S_OK;
+}
+
+/* Properties of elements removed from the storage may still be referenced by their DISPID. */
+static HRESULT Array_prop_get(jsdisp_t *dispex, unsigned idx, jsval_t *r)
+{
+    ArrayInstance *array = array_from_jsdisp(dispex);
+
+    TRACE("%p[%u]\n", array, idx);
+
+    if(idx >= array->elems_cnt) {
+        *r = jsval_undefined();
+        return S_OK;
+    }
+    return jsval_copy(array->elems[idx], r);
+}
+
+static HRESULT Array_prop_put(jsdisp_t *dispex, unsigned idx, jsval_t val)
+{
+    ArrayInstance *array = array_from_jsdisp(dispex);
+
+    TRACE("%p[%u] = %s\n", array, idx, debugstr_jsval(val));
+
+    if(idx >= array->elems_cnt)
+        return S_FALSE;
+    return array_set_elem(dispex, idx, val);
+}
+
+static HRESULT Array_prop_delete(jsdisp_t *dispex, unsigned idx)
+{
+    ArrayInstance *array = array_from_jsdisp(dispex);
+    HRESULT hres;
+
+    TRACE("%p[%u]\n", array, idx);
+
+    if(idx >= array->elems_cnt)
+        return S_OK;
+
+    /* Elements following a hole are stored as regular properties */
+    if(idx + 1 < array->elems_cnt) {
+        hres = spill_elems(array, idx + 1);
+        if(FAILED(hres))
+            return hres;
+    }
+
+    return array_delete_elem(dispex, idx);
+}
+
+static HRESULT Array_prop_config(jsdisp_t *dispex, unsigned idx, unsigned flags)
+{
+    ArrayInstance *array = array_from_jsdisp(dispex);
+
+    TRACE("%p[%u] %x\n", array, idx, flags);
+
+    if(idx >= array->elems_cnt || (flags & PROPF_ALL) == PROPF_ALL)
+        return S_OK;
+
+    /* Only plain data elements are stored, turn the rest into regular properties */
+    return spill_elems(array, idx);
+}
+
+static HRESULT Array_gc_traverse(struct gc_ctx *gc_ctx, enum gc_traverse_op op, jsdisp_t *dispex)
+{
+    ArrayInstance *array = array_from_jsdisp(dispex);
+    HRESULT hres;
+    DWORD i;
+
+    for(i = 0; i < array->elems_cnt; i++) {
+        hres = gc_process_linked_val(gc_ctx, op, dispex, &array->elems[i]);
+        if(FAILED(hres))
+            return hres;
+    }
+    return S_OK;
+}
+
 static void Array_on_put(jsdisp_t *dispex, const WCHAR *name)
 {
     ArrayInstance *array = array_from_jsdisp(dispex);
@@ -1635,10 +2002,18 @@ static const builtin_prop_t Array_props[] = {
 };
 
 static const builtin_info_t Array_info = {
-    .class      = JSCLASS_ARRAY,
-    .props_cnt  = ARRAY_SIZE(Array_props),
-    .props      = Array_props,
-    .on_put     = Array_on_put,
+    .class       = JSCLASS_ARRAY,
+    .props_cnt   = ARRAY_SIZE(Array_props),
+    .props       = Array_props,
+    .destructor  = Array_destructor,
+    .on_put      = Array_on_put,
+    .lookup_prop = Array_lookup_prop,
+    .next_prop   = Array_next_prop,
+    .prop_get    = Array_prop_get,
+    .prop_put    = Array_prop_put,
+    .prop_delete = Array_prop_delete,
+    .prop_config = Array_prop_config,
+    .gc_traverse = Array_gc_traverse,
 };
 
 static const builtin_prop_t ArrayInst_props[] = {
@@ -1646,10 +2021,18 @@ static const builtin_prop_t ArrayInst_props[] = {
 };
 
 static const builtin_info_t ArrayInst_info = {
-    .class      = JSCLASS_ARRAY,
-    .props_cnt  = ARRAY_SIZE(ArrayInst_props),
-    .props      = ArrayInst_props,
-    .on_put     = Array_on_put,
+    .class       = JSCLASS_ARRAY,
+    .props_cnt   = ARRAY_SIZE(ArrayInst_props),
+    .props       = ArrayInst_props,
+    .destructor  = Array_destructor,
+    .on_put      = Array_on_put,
+    .lookup_prop = Array_lookup_prop,
+    .next_prop   = Array_next_prop,
+    .prop_get    = Array_prop_get,
+    .prop_put    = Array_prop_put,
+    .prop_delete = Array_prop_delete,
+    .prop_config = Array_prop_config,
+    .gc_traverse = Array_gc_traverse,
 };
 
 /* ECMA-262 5.1 Edition    15.4.3.2 */
@@ -51,6 +51,12 @@ typedef struct {
     int ref;
 } function_local_t;
 
+typedef struct _outer_function_t {
+    function_code_t *func;
+    unsigned int scope_index; /* scope of the function being compiled */
+    struct _outer_function_t *next;
+} outer_function_t;
+
 typedef struct _compiler_ctx_t {
     parser_ctx_t *parser;
     bytecode_t *code;
@@ -82,6 +88,7 @@ typedef struct _compiler_ctx_t {
     function_expression_t *func_head;
     function_expression_t *func_tail;
     function_expression_t *current_function_expr;
+    outer_function_t *outer;
 
     heap_pool_t heap;
 } compiler_ctx_t;
@@ -105,6 +112,9 @@ static void dump_instr_arg(instr_arg_type_t type, instr_arg_t *arg)
     case ARG_BSTR:
         TRACE_(jscript_disas)("\t%s", debugstr_wn(arg->bstr, SysStringLen(arg->bstr)));
         break;
+    case ARG_OUTER:
+        TRACE_(jscript_disas)("\t%s", debugstr_w(arg->outer->name));
+        break;
     case ARG_INT:
         TRACE_(jscript_disas)("\t%d", arg->uint);
         break;
@@ -112,6 +122,7 @@ static void dump_instr_arg(instr_arg_type_t type, instr_arg_t *arg)
     case ARG_ADDR:
         TRACE_(jscript_disas)("\t%u", arg->uint);
         break;
+    case ARG_CACHE:
     case ARG_FUNC:
     case ARG_NONE:
         break;
@@ -349,6 +360,48 @@ static HRESULT push_instr_bstr(compiler_ctx_t *ctx, jsop_t op, const WCHAR *arg)
     return S_OK;
 }
 
+static HRESULT push_instr_prop_cache(compiler_ctx_t *ctx, unsigned instr)
+{
+    prop_cache_t *cache;
+
+    cache = compiler_alloc(ctx->code, sizeof(*cache));
+    if(!cache)
+        return E_OUTOFMEMORY;
+
+    memset(cache->idx, 0xff, sizeof(cache->idx));
+    instr_ptr(ctx, instr)->u.arg[1].cache = cache;
+    return S_OK;
+}
+
+static HRESULT push_instr_member(compiler_ctx_t *ctx, const WCHAR *name)
+{
+    unsigned instr;
+    WCHAR *str;
+
+    str = compiler_alloc_bstr(ctx, name);
+    if(!str)
+        return E_OUTOFMEMORY;
+
+    instr = push_instr(ctx, OP_member);
+    if(!instr)
+        return E_OUTOFMEMORY;
+
+    instr_ptr(ctx, instr)->u.arg[0].bstr = str;
+    return push_instr_prop_cache(ctx, instr);
+}
+
+static HRESULT push_instr_memberid(compiler_ctx_t *ctx, unsigned flags)
+{
+    unsigned instr;
+
+    instr = push_instr(ctx, OP_memberid);
+    if(!instr)
+        return E_OUTOFMEMORY;
+
+    instr_ptr(ctx, instr)->u.arg[0].uint = flags;
+    return push_instr_prop_cache(ctx, instr);
+}
+
 static HRESULT push_instr_bstr_uint(compiler_ctx_t *ctx, jsop_t op, const WCHAR *arg1, unsigned arg2)
 {
     unsigned instr;
@@ -449,7 +502,7 @@ static HRESULT compile_member_expression(compiler_ctx_t *ctx, member_expression_
     if(FAILED(hres))
         return hres;
 
-    return push_instr_bstr(ctx, OP_member, expr->identifier);
+    return push_instr_member(ctx, expr->identifier);
 }
 
 #define LABEL_FLAG 0x80000000
@@ -513,19 +566,105 @@ static BOOL bind_local(compiler_ctx_t *ctx, const WCHAR *identifier, int *ret_re
     return TRUE;
 }
 
+/*
+ * Binds identifiers to variables of enclosing functions. The interpreter accesses them
+ * directly on the stack as long as their frames are attached and no dynamic scope is
+ * on the way, and falls back to the lookup by name otherwise.
+ */
+static HRESULT bind_outer_local(compiler_ctx_t *ctx, const WCHAR *identifier, outer_local_t **ret)
+{
+    outer_function_t *outer;
+    statement_ctx_t *iter;
+    unsigned int scope;
+    local_ref_t *ref;
+
+    *ret = NULL;
+
+    if(!wcscmp(identifier, L"arguments"))
+        return S_OK;
+    if(ctx->func->name && !wcscmp(identifier, ctx->func->name))
+        return S_OK;
+
+    for(iter = ctx->stat_ctx; iter; iter = iter->next) {
+        if(iter->using_scope && !iter->block_scope)
+            return S_OK;
+    }
+
+    /* The outermost code is global or eval code, its variables are not on the stack. */
+    for(outer = ctx->outer; outer && outer->next; outer = outer->next) {
+        scope = outer->scope_index;
+        ref = lookup_local(outer->func, identifier, scope);
+        if(!ref && scope) {
+            scope = 0;
+            ref = lookup_local(outer->func, identifier, scope);
+        }
+
+        if(ref) {
+            if(!(*ret = compiler_alloc(ctx->code, sizeof(**ret))))
+                return E_OUTOFMEMORY;
+            if(!((*ret)->name = compiler_alloc_bstr(ctx, identifier)))
+                return E_OUTOFMEMORY;
+            (*ret)->func = outer->func;
+            (*ret)->scope_index = scope;
+            (*ret)->ref = ref->ref;
+            return S_OK;
+        }
+
+        if(outer->func->name && !wcscmp(identifier, outer->func->name))
+            return S_OK;
+    }
+
+    return S_OK;
+}
+
 static HRESULT emit_identifier_ref(compiler_ctx_t *ctx, const WCHAR *identifier, unsigned flags)
 {
+    outer_local_t *outer_local;
+    unsigned instr;
     int local_ref;
+    HRESULT hres;
+
     if(bind_local(ctx, identifier, &local_ref))
         return push_instr_int(ctx, OP_local_ref, local_ref);
+
+    hres = bind_outer_local(ctx, identifier, &outer_local);
+    if(FAILED(hres))
+        return hres;
+    if(outer_local) {
+        instr = push_instr(ctx, OP_outer_local_ref);
+        if(!instr)
+            return E_OUTOFMEMORY;
+
+        instr_ptr(ctx, instr)->u.arg[0].outer = outer_local;
+        instr_ptr(ctx, instr)->u.arg[1].uint = flags;
+        return S_OK;
+    }
+
     return push_instr_bstr_uint(ctx, OP_identid, identifier, flags);
 }
 
 static HRESULT emit_identifier(compiler_ctx_t *ctx, const WCHAR *identifier)
 {
+    outer_local_t *outer_local;
+    unsigned instr;
     int local_ref;
+    HRESULT hres;
+
     if(bind_local(ctx, identifier, &local_ref))
         return push_instr_int(ctx, OP_local, local_ref);
+
+    hres = bind_outer_local(ctx, identifier, &outer_local);
+    if(FAILED(hres))
+        return hres;
+    if(outer_local) {
+        instr = push_instr(ctx, OP_outer_local);
+        if(!instr)
+            return E_OUTOFMEMORY;
+
+        instr_ptr(ctx, instr)->u.arg[0].outer = outer_local;
+        return S_OK;
+    }
+
     return push_instr_bstr(ctx, OP_ident, identifier);
 }
 
@@ -599,7 +738,7 @@ static HRESULT compile_memberid_expression(compiler_ctx_t *ctx, expression_t *ex
     if(FAILED(hres))
         return hres;
 
-    return push_instr_uint(ctx, OP_memberid, flags);
+    return push_instr_memberid(ctx, flags);
 }
 
 static HRESULT compile_increment_expression(compiler_ctx_t *ctx, unary_expression_t *expr, jsop_t op, int n)
@@ -2519,6 +2658,7 @@ static HRESULT compile_function(compiler_ctx_t *ctx, statement_t *source, functi
 {
     function_expression_t *iter;
     function_local_t *local;
+    outer_function_t outer;
     unsigned off, i, scope;
     HRESULT hres;
 
@@ -2628,10 +2768,17 @@ static HRESULT compile_function(compiler_ctx_t *ctx, statement_t *source, functi
 
     func->instr_off = off;
 
+    outer.func = func;
+    outer.next = ctx->outer;
+    ctx->outer = &outer;
+
     for(iter = ctx->func_head, i=0; iter; iter = iter->next, i++) {
+        outer.scope_index = iter->scope_index;
         hres = compile_function(ctx, iter->statement_list, iter, FALSE, func->funcs+i);
-        if(FAILED(hres))
+        if(FAILED(hres)) {
+            ctx->outer = outer.next;
             return hres;
+        }
 
         func->funcs[i].scope_index = iter->scope_index;
 
@@ -2647,6 +2794,7 @@ static HRESULT compile_function(compiler_ctx_t *ctx, statement_t *source, functi
         }
     }
 
+    ctx->outer = outer.next;
     assert(i == func->func_cnt);
 
     return S_OK;
@@ -2722,13 +2870,150 @@ static HRESULT compile_arguments(compiler_ctx_t *ctx, const WCHAR *args)
     return parse_arguments(ctx, args, ctx->code->global_code.params, NULL);
 }
 
+/*
+ * Compiled global code is kept per thread, so that script contexts running the same source
+ * (like short-lived engine instances created for each request) don't need to compile it
+ * again. Bytecode is not thread safe and carries per-context state while it's in use (its
+ * named item and list entry), so a cached entry is only handed out when nothing else holds
+ * a reference to it. The cache is freed with the thread data, once the last script context
+ * of the thread is released.
+ */
+#define CODE_CACHE_SIZE 32
+
+struct code_cache_entry {
+    struct list entry;
+    bytecode_t *code;
+    unsigned hash;
+    DWORD version;
+    WCHAR *args;
+    WCHAR *delimiter;
+    UINT64 compile_time;
+};
+
+static BOOL is_code_cacheable(const WCHAR *code, BOOL from_eval, BOOL use_decode, named_item_t *named_item)
+{
+    /* Conditional compilation both depends on and changes the state of the script context. */
+    return code && !from_eval && !use_decode && !named_item && !wcschr(code, '@');
+}
+
+static unsigned code_hash(const WCHAR *code)
+{
+    unsigned h = 0;
+    for(; *code; code++)
+        h = (h>>(sizeof(unsigned)*8-4)) ^ (h<<4) ^ *code;
+    return h;
+}
+
+static BOOL wcs_eq_null(const WCHAR *str1, const WCHAR *str2)
+{
+    return str1 && str2 ? !wcscmp(str1, str2) : str1 == str2;
+}
+
+static void free_code_cache_entry(struct code_cache_entry *entry)
+{
+    release_bytecode(entry->code);
+    free(entry->args);
+    free(entry->delimiter);
+    free(entry);
+}
+
+/*
+ * Returns the cached code for the given source, or NULL if there is none. If the code is
+ * cached, but still in use, NULL is returned and *in_use is set, and the newly compiled
+ * code is not added to the cache.
+ */
+static bytecode_t *lookup_code_cache(script_ctx_t *ctx, const WCHAR *code, unsigned hash, UINT64 source_context,
+                                     unsigned start_line, const WCHAR *args, const WCHAR *delimiter, BOOL *in_use)
+{
+    struct thread_data *thread_data = ctx->thread_data;
+    struct code_cache_entry *entry;
+    LARGE_INTEGER freq;
+
+    LIST_FOR_EACH_ENTRY(entry, &thread_data->code_cache, struct code_cache_entry, entry) {
+        if(entry->hash != hash || entry->version != ctx->version
+           || entry->code->source_context != source_context || entry->code->start_line != start_line
+           || !wcs_eq_null(entry->args, args) || !wcs_eq_null(entry->delimiter, delimiter)
+           || wcscmp(entry->code->source, code))
+            continue;
+
+        if(entry->code->ref != 1) {
+            *in_use = TRUE;
+            return NULL;
+        }
+
+        list_remove(&entry->entry);
+        list_add_head(&thread_data->code_cache, &entry->entry);
+
+        thread_data->code_cache_saved += entry->compile_time;
+        if(TRACE_ON(jscript)) {
+            QueryPerformanceFrequency(&freq);
+            TRACE("reusing %p, saved %I64u us (%I64u us total)\n", entry->code,
+                  entry->compile_time * 1000000 / freq.QuadPart,
+                  thread_data->code_cache_saved * 1000000 / freq.QuadPart);
+        }
+
+        entry->code->is_persistent = FALSE;
+        return bytecode_addref(entry->code);
+    }
+
+    return NULL;
+}
+
+static void add_code_cache(script_ctx_t *ctx, bytecode_t *code, unsigned hash, const WCHAR *args,
+                           const WCHAR *delimiter, UINT64 compile_time)
+{
+    struct thread_data *thread_data = ctx->thread_data;
+    struct code_cache_entry *entry;
+
+    if(!(entry = calloc(1, sizeof(*entry))))
+        return;
+    if((args && !(entry->args = wcsdup(args))) || (delimiter && !(entry->delimiter = wcsdup(delimiter)))) {
+        free(entry->args);
+        free(entry);
+        return;
+    }
+
+    entry->code = bytecode_addref(code);
+    entry->hash = hash;
+    entry->version = ctx->version;
+    entry->compile_time = compile_time;
+
+    if(thread_data->code_cache_cnt == CODE_CACHE_SIZE) {
+        struct code_cache_entry *lru = LIST_ENTRY(list_tail(&thread_data->code_cache), struct code_cache_entry, entry);
+        list_remove(&lru->entry);
+        free_code_cache_entry(lru);
+    }else {
+        thread_data->code_cache_cnt++;
+    }
+    list_add_head(&thread_data->code_cache, &entry->entry);
+}
+
+void release_code_cache(struct thread_data *thread_data)
+{
+    struct code_cache_entry *entry, *next;
+
+    LIST_FOR_EACH_ENTRY_SAFE(entry, next, &thread_data->code_cache, struct code_cache_entry, entry)
+        free_code_cache_entry(entry);
+}
+
 HRESULT compile_script(script_ctx_t *ctx, const WCHAR *code, UINT64 source_context, unsigned start_line,
                        const WCHAR *args, const WCHAR *delimiter, BOOL from_eval, BOOL use_decode,
                        named_item_t *named_item, bytecode_t **ret)
 {
     compiler_ctx_t compiler = {0};
+    LARGE_INTEGER start, end;
+    BOOL cacheable, in_use = FALSE;
+    unsigned hash = 0;
     HRESULT hres;
 
+    cacheable = is_code_cacheable(code, from_eval, use_decode, named_item);
+    if(cacheable) {
+        hash = code_hash(code);
+        if((*ret = lookup_code_cache(ctx, code, hash, source_context, start_line, args, delimiter, &in_use)))
+            return S_OK;
+        QueryPerformanceCounter(&start);
+    }
+
     hres = init_code(&compiler, code, source_context, start_line);
     if(FAILED(hres))
         return hres;
@@ -2771,6 +3056,11 @@ HRESULT compile_script(script_ctx_t *ctx, const WCHAR *code, UINT64 source_conte
         named_item->ref++;
     }
 
+    if(cacheable && !in_use) {
+        QueryPerformanceCounter(&end);
+        add_code_cache(ctx, compiler.code, hash, args, delimiter, end.QuadPart - start.QuadPart);
+    }
+
     *ret = compiler.code;
     return S_OK;
 }
@@ -24,6 +24,7 @@
 #include "wine/debug.h"
 
 WINE_DEFAULT_DEBUG_CHANNEL(jscript);
+WINE_DECLARE_DEBUG_CHANNEL(jscript_gc);
 
 static const GUID GUID_JScriptTypeInfo = {0xc59c6b12,0xf6c1,0x11cf,{0x88,0x35,0x00,0xa0,0xc9,0x11,0xe8,0xb2}};
 
@@ -501,6 +502,33 @@ HRESULT jsdisp_index_lookup(jsdisp_t *obj, const WCHAR *name, unsigned length, s
     return S_OK;
 }
 
+/* Called before lookup_prop starts providing a new index on its own. Fails if the name is
+   used by an own property or a prototype accessor, and drops stale prototype references. */
+BOOL jsdisp_claim_index(jsdisp_t *obj, unsigned idx)
+{
+    dispex_prop_t *prop, *own_prop;
+    WCHAR buf[12];
+    unsigned hash;
+    jsdisp_t *iter;
+
+    swprintf(buf, ARRAY_SIZE(buf), L"%u", idx);
+    hash = string_hash(buf);
+
+    own_prop = lookup_dispex_prop(obj, hash, buf, FALSE);
+    if(own_prop && own_prop->type != PROP_DELETED && own_prop->type != PROP_EXTERN && own_prop->type != PROP_PROTREF)
+        return FALSE;
+
+    for(iter = obj->prototype; iter; iter = iter->prototype) {
+        prop = lookup_dispex_prop(iter, hash, buf, FALSE);
+        if(prop && prop->type == PROP_ACCESSOR)
+            return FALSE;
+    }
+
+    if(own_prop && own_prop->type == PROP_PROTREF)
+        own_prop->type = PROP_DELETED;
+    return TRUE;
+}
+
 HRESULT jsdisp_next_index(jsdisp_t *obj, unsigned length, unsigned id, struct property_info *desc)
 {
     if(id + 1 == length)
@@ -892,6 +920,9 @@ struct gc_ctx {
     unsigned idx;
 };
 
+/* Minimal number of objects the heap has to grow by before the next automatic collection */
+#define GC_MIN_GROWTH 1024
+
 static HRESULT gc_stack_push(struct gc_ctx *gc_ctx, jsdisp_t *obj)
 {
     if(!gc_ctx->idx) {
@@ -937,7 +968,8 @@ HRESULT gc_run(script_ctx_t *ctx)
     jsdisp_t *obj, *obj2, *link, *link2;
     dispex_prop_t *prop, *props_end;
     struct gc_ctx gc_ctx = { 0 };
-    unsigned chunk_idx = 0;
+    unsigned chunk_idx = 0, obj_cnt;
+    LARGE_INTEGER start, end, freq;
     HRESULT hres = S_OK;
     struct list *iter;
 
@@ -945,6 +977,10 @@ HRESULT gc_run(script_ctx_t *ctx)
     if(thread_data->gc_is_unlinking)
         return S_OK;
 
+    obj_cnt = thread_data->gc_obj_cnt;
+    if(TRACE_ON(jscript_gc))
+        QueryPerformanceCounter(&start);
+
     if(!(head = malloc(sizeof(*head))))
         return E_OUTOFMEMORY;
     head->next = NULL;
@@ -1117,7 +1153,15 @@ HRESULT gc_run(script_ctx_t *ctx)
     }
 
     thread_data->gc_is_unlinking = FALSE;
-    thread_data->gc_last_tick = GetTickCount();
+    thread_data->gc_threshold = thread_data->gc_obj_cnt + max(thread_data->gc_obj_cnt / 2, GC_MIN_GROWTH);
+
+    if(TRACE_ON(jscript_gc)) {
+        QueryPerformanceCounter(&end);
+        QueryPerformanceFrequency(&freq);
+        TRACE_(jscript_gc)("collected %u of %u objects in %I64u us, next collection at %u objects\n",
+                           obj_cnt - thread_data->gc_obj_cnt, obj_cnt,
+                           (end.QuadPart - start.QuadPart) * 1000000 / freq.QuadPart, thread_data->gc_threshold);
+    }
     return S_OK;
 }
 
@@ -1863,6 +1907,7 @@ static void jsdisp_free(jsdisp_t *obj)
     dispex_prop_t *prop;
 
     list_remove(&obj->entry);
+    obj->ctx->thread_data->gc_obj_cnt--;
 
     TRACE("(%p)\n", obj);
 
@@ -2272,10 +2317,13 @@ static HRESULT delete_prop(jsdisp_t *obj, dispex_prop_t *prop, BOOL *ret)
         break;
     case PROP_EXTERN:
         if(obj->builtin_info->prop_delete) {
+            DWORD idx = prop - obj->props;
             HRESULT hres;
             hres = obj->builtin_info->prop_delete(obj, prop->u.id);
             if(FAILED(hres))
                 return hres;
+            /* prop_delete may add properties and reallocate the table */
+            prop = &obj->props[idx];
         }
         break;
     default:
@@ -2455,8 +2503,10 @@ HRESULT init_dispex(jsdisp_t *dispex, script_ctx_t *ctx, const builtin_info_t *b
 {
     unsigned i;
 
-    /* FIXME: Use better heuristics to decide when to run the GC */
-    if(GetTickCount() - ctx->thread_data->gc_last_tick > 30000)
+    /* Objects that are not part of a cycle are freed by their refcount as soon as they
+       become unreachable, so only run the collector once the heap has grown enough
+       since the last run to be worth a full pass. */
+    if(ctx->thread_data->gc_obj_cnt >= max(ctx->thread_data->gc_threshold, GC_MIN_GROWTH))
         gc_run(ctx);
 
     TRACE("%p (%p)\n", dispex, prototype);
@@ -2485,6 +2535,7 @@ HRESULT init_dispex(jsdisp_t *dispex, script_ctx_t *ctx, const builtin_info_t *b
     dispex->ctx = ctx;
 
     list_add_tail(&ctx->thread_data->objects, &dispex->entry);
+    ctx->thread_data->gc_obj_cnt++;
     return S_OK;
 }
 
@@ -2570,6 +2621,48 @@ HRESULT jsdisp_get_id(jsdisp_t *jsdisp, const WCHAR *name, DWORD flags, DISPID *
     return DISP_E_UNKNOWNNAME;
 }
 
+/*
+ * Property tables are never compacted, so objects created the same way keep their
+ * properties at the same indices. Member access opcodes remember recently seen
+ * indices and only need to check the name stored there before falling back to a
+ * full lookup.
+ */
+HRESULT jsdisp_get_id_cached(jsdisp_t *jsdisp, const WCHAR *name, DWORD flags, prop_cache_t *cache, DISPID *id)
+{
+    dispex_prop_t *prop;
+    unsigned i, idx;
+    HRESULT hres;
+
+    if(!(flags & fdexNameCaseInsensitive)) {
+        for(i = 0; i < ARRAY_SIZE(cache->idx); i++) {
+            idx = cache->idx[i];
+            if(idx >= jsdisp->prop_cnt)
+                continue;
+
+            prop = jsdisp->props + idx;
+            if(prop->type == PROP_DELETED || prop->type == PROP_EXTERN || wcscmp(prop->name, name))
+                continue;
+            fix_protref_prop(jsdisp, prop);
+            if(prop->type == PROP_DELETED)
+                continue;
+
+            if(i) {
+                memmove(cache->idx + 1, cache->idx, i * sizeof(*cache->idx));
+                cache->idx[0] = idx;
+            }
+            *id = prop_to_id(jsdisp, prop);
+            return S_OK;
+        }
+    }
+
+    hres = jsdisp_get_id(jsdisp, name, flags, id);
+    if(hres == S_OK && !(flags & fdexNameCaseInsensitive)) {
+        memmove(cache->idx + 1, cache->idx, (ARRAY_SIZE(cache->idx) - 1) * sizeof(*cache->idx));
+        cache->idx[0] = *id - 1;
+    }
+    return hres;
+}
+
 HRESULT jsdisp_get_idx_id(jsdisp_t *jsdisp, DWORD idx, DISPID *id)
 {
     WCHAR name[11];
@@ -2865,6 +2958,12 @@ HRESULT jsdisp_propput_idx(jsdisp_t *obj, DWORD idx, jsval_t val)
 {
     WCHAR buf[12];
 
+    if(is_class(obj, JSCLASS_ARRAY)) {
+        HRESULT hres = array_set_elem(obj, idx, val);
+        if(hres != S_FALSE)
+            return hres;
+    }
+
     swprintf(buf, ARRAY_SIZE(buf), L"%d", idx);
     return jsdisp_propput(obj, buf, PROPF_ENUMERABLE | PROPF_CONFIGURABLE | PROPF_WRITABLE, TRUE, val);
 }
@@ -2966,6 +3065,12 @@ HRESULT jsdisp_get_idx(jsdisp_t *obj, DWORD idx, jsval_t *r)
     dispex_prop_t *prop;
     HRESULT hres;
 
+    if(is_class(obj, JSCLASS_ARRAY)) {
+        hres = array_get_elem(obj, idx, r);
+        if(hres != S_FALSE)
+            return hres;
+    }
+
     swprintf(name, ARRAY_SIZE(name), L"%d", idx);
 
     hres = find_prop_name_prot(obj, string_hash(name), name, FALSE, NULL, &prop);
@@ -3023,6 +3128,12 @@ HRESULT jsdisp_delete_idx(jsdisp_t *obj, DWORD idx)
     BOOL b;
     HRESULT hres;
 
+    if(is_class(obj, JSCLASS_ARRAY)) {
+        hres = array_delete_elem(obj, idx);
+        if(hres != S_FALSE)
+            return hres;
+    }
+
     swprintf(buf, ARRAY_SIZE(buf), L"%d", idx);
 
     hres = find_prop_name(obj, string_hash(buf), buf, FALSE, NULL, &prop);
@@ -3213,9 +3324,24 @@ HRESULT jsdisp_get_own_property(jsdisp_t *obj, const WCHAR *name, BOOL flags_onl
     return S_OK;
 }
 
+static void set_prop_flags(jsdisp_t *obj, DWORD idx, UINT32 flags)
+{
+    dispex_prop_t *prop = &obj->props[idx];
+
+    if(prop->type == PROP_EXTERN && obj->builtin_info->prop_config) {
+        HRESULT hres = obj->builtin_info->prop_config(obj, prop->u.id, flags);
+        if(hres != S_OK)
+            return;
+        /* prop_config may replace the property by a regular one, reallocating the table */
+        prop = &obj->props[idx];
+    }
+    prop->flags = (prop->flags & ~PROPF_PUBLIC_MASK) | flags;
+}
+
 HRESULT jsdisp_define_property(jsdisp_t *obj, const WCHAR *name, property_desc_t *desc)
 {
     dispex_prop_t *prop;
+    DWORD prop_idx;
     HRESULT hres;
 
     hres = find_prop_name(obj, string_hash(name), name, FALSE, NULL, &prop);
@@ -3253,6 +3379,9 @@ HRESULT jsdisp_define_property(jsdisp_t *obj, const WCHAR *name, property_desc_t
     TRACE("existing prop %s prop flags %lx desc flags %x desc mask %x\n", debugstr_w(name),
           prop->flags, desc->flags, desc->mask);
 
+    /* Callbacks of external properties may add properties and reallocate the table */
+    prop_idx = prop - obj->props;
+
     if(!(prop->flags & PROPF_CONFIGURABLE)) {
         if(((desc->mask & PROPF_CONFIGURABLE) && (desc->flags & PROPF_CONFIGURABLE))
            || ((desc->mask & PROPF_ENUMERABLE)
@@ -3300,6 +3429,7 @@ HRESULT jsdisp_define_property(jsdisp_t *obj, const WCHAR *name, property_desc_t
                         hres = obj->builtin_info->prop_delete(obj, prop->u.id);
                         if(FAILED(hres))
                             return hres;
+                        prop = &obj->props[prop_idx];
                     }
                     prop->type = PROP_JSVAL;
                 }
@@ -3316,6 +3446,12 @@ HRESULT jsdisp_define_property(jsdisp_t *obj, const WCHAR *name, property_desc_t
                 return throw_error(obj->ctx, JS_E_NONCONFIGURABLE_REDEFINED, name);
             if(prop->type == PROP_JSVAL)
                 jsval_release(prop->u.val);
+            else if(prop->type == PROP_EXTERN && obj->builtin_info->prop_delete) {
+                hres = obj->builtin_info->prop_delete(obj, prop->u.id);
+                if(FAILED(hres))
+                    return hres;
+                prop = &obj->props[prop_idx];
+            }
             prop->type = PROP_ACCESSOR;
             prop->u.accessor.getter = prop->u.accessor.setter = NULL;
         }else if(!(prop->flags & PROPF_CONFIGURABLE)) {
@@ -3342,7 +3478,10 @@ HRESULT jsdisp_define_property(jsdisp_t *obj, const WCHAR *name, property_desc_t
         }
     }
 
-    prop->flags = (prop->flags & ~desc->mask) | (desc->flags & desc->mask);
+    if(prop->type == PROP_EXTERN)
+        set_prop_flags(obj, prop_idx, ((prop->flags & ~desc->mask) | (desc->flags & desc->mask)) & PROPF_PUBLIC_MASK);
+    else
+        prop->flags = (prop->flags & ~desc->mask) | (desc->flags & desc->mask);
     return S_OK;
 }
 
@@ -3380,26 +3519,16 @@ HRESULT jsdisp_change_prototype(jsdisp_t *obj, jsdisp_t *proto)
     return S_OK;
 }
 
-static void set_prop_flags(jsdisp_t *obj, dispex_prop_t *prop, UINT32 flags)
-{
-    if(prop->type == PROP_EXTERN && obj->builtin_info->prop_config) {
-        HRESULT hres = obj->builtin_info->prop_config(obj, prop->u.id, flags);
-        if(hres != S_OK)
-            return;
-    }
-    prop->flags = (prop->flags & ~PROPF_PUBLIC_MASK) | flags;
-}
-
 void jsdisp_freeze(jsdisp_t *obj, BOOL seal)
 {
     unsigned int i;
 
     fill_props(obj);
     for(i = 0; i < obj->prop_cnt; i++) {
-        unsigned int mask = PROPF_CONFIGURABLE;
+        set_prop_flags(obj, i, obj->props[i].flags & PROPF_PUBLIC_MASK & ~PROPF_CONFIGURABLE);
+        /* prop_config may have replaced an external property by a regular one */
         if(!seal && obj->props[i].type == PROP_JSVAL)
-            mask |= PROPF_WRITABLE;
-        set_prop_flags(obj, &obj->props[i], obj->props[i].flags & PROPF_PUBLIC_MASK & ~mask);
+            obj->props[i].flags &= ~PROPF_WRITABLE;
     }
 
     obj->extensible = FALSE;
@@ -621,6 +621,18 @@ static HRESULT disp_get_id(script_ctx_t *ctx, IDispatch *disp, const WCHAR *name
     return hres;
 }
 
+static HRESULT disp_get_id_cached(script_ctx_t *ctx, IDispatch *disp, const WCHAR *name, BSTR name_bstr, DWORD flags,
+        prop_cache_t *cache, DISPID *id)
+{
+    jsdisp_t *jsdisp;
+
+    jsdisp = to_jsdisp(disp);
+    if(jsdisp)
+        return jsdisp_get_id_cached(jsdisp, name, flags, cache, id);
+
+    return disp_get_id(ctx, disp, name, name_bstr, flags, id);
+}
+
 static HRESULT disp_cmp(IDispatch *disp1, IDispatch *disp2, BOOL *ret)
 {
     IObjectIdentity *identity;
@@ -962,6 +974,18 @@ static inline unsigned get_op_uint(script_ctx_t *ctx, int i)
     return frame->bytecode->instrs[frame->ip].u.arg[i].uint;
 }
 
+static inline prop_cache_t *get_op_prop_cache(script_ctx_t *ctx, int i)
+{
+    call_frame_t *frame = ctx->call_ctx;
+    return frame->bytecode->instrs[frame->ip].u.arg[i].cache;
+}
+
+static inline const outer_local_t *get_op_outer_local(script_ctx_t *ctx, int i)
+{
+    call_frame_t *frame = ctx->call_ctx;
+    return frame->bytecode->instrs[frame->ip].u.arg[i].outer;
+}
+
 static inline unsigned get_op_int(script_ctx_t *ctx, int i)
 {
     call_frame_t *frame = ctx->call_ctx;
@@ -1392,6 +1416,7 @@ static HRESULT interp_array(script_ctx_t *ctx)
     jsstr_t *name_str;
     const WCHAR *name;
     jsval_t v, namev;
+    jsdisp_t *jsdisp;
     IDispatch *obj;
     DISPID id;
     HRESULT hres;
@@ -1406,6 +1431,20 @@ static HRESULT interp_array(script_ctx_t *ctx)
         return hres;
     }
 
+    if(is_number(namev) && (jsdisp = to_jsdisp(obj)) && jsdisp->ctx == ctx && is_class(jsdisp, JSCLASS_ARRAY)) {
+        double n = get_number(namev);
+
+        if(n >= 0 && n < UINT_MAX && n == (DWORD)n) {
+            hres = array_get_elem(jsdisp, n, &v);
+            if(hres != S_FALSE) {
+                IDispatch_Release(obj);
+                if(FAILED(hres))
+                    return hres;
+                return stack_push(ctx, v);
+            }
+        }
+    }
+
     hres = to_flat_string(ctx, namev, &name_str, &name);
     jsval_release(namev);
     if(FAILED(hres)) {
@@ -1443,7 +1482,7 @@ static HRESULT interp_member(script_ctx_t *ctx)
     if(FAILED(hres))
         return hres;
 
-    hres = disp_get_id(ctx, obj, arg, arg, 0, &id);
+    hres = disp_get_id_cached(ctx, obj, arg, arg, 0, get_op_prop_cache(ctx, 1), &id);
     if(SUCCEEDED(hres)) {
         hres = disp_propget(ctx, obj, id, &v);
     }else if(hres == DISP_E_UNKNOWNNAME) {
@@ -1485,7 +1524,7 @@ static HRESULT interp_memberid(script_ctx_t *ctx)
     if(FAILED(hres))
         return hres;
 
-    hres = disp_get_id(ctx, obj, name, NULL, arg, &id);
+    hres = disp_get_id_cached(ctx, obj, name, NULL, arg, get_op_prop_cache(ctx, 1), &id);
     jsstr_release(name_str);
     if(SUCCEEDED(hres)) {
         ref.type = EXPRVAL_IDREF;
@@ -1725,6 +1764,74 @@ static HRESULT interp_local(script_ctx_t *ctx)
     return stack_push(ctx, copy);
 }
 
+/*
+ * Finds the stack slot of a variable bound by the compiler to an enclosing function.
+ * Fails if the frame has been detached or if a dynamic scope could shadow the variable,
+ * the caller needs to look the identifier up by name in that case.
+ */
+static BOOL lookup_outer_local(script_ctx_t *ctx, const outer_local_t *outer, unsigned *off)
+{
+    scope_chain_t *scope;
+    jsdisp_t *obj;
+
+    for(scope = ctx->call_ctx->scope; scope; scope = scope->next) {
+        if(!scope->frame) {
+            /* Block scopes without locals are transparent. */
+            if(scope->obj || scope->detached_vars)
+                return FALSE;
+            continue;
+        }
+
+        if(scope->frame->function == outer->func && scope->scope_index == outer->scope_index) {
+            *off = local_off(scope->frame, outer->ref);
+            return TRUE;
+        }
+
+        /* Function scopes on the way were checked by the compiler, but not their block scopes. */
+        if(scope->scope_index && lookup_local(scope->frame->function, outer->name, scope->scope_index))
+            return FALSE;
+        if(scope->obj && (!(obj = to_jsdisp(scope->obj)) || obj->prop_cnt))
+            return FALSE;
+    }
+
+    return FALSE;
+}
+
+static HRESULT interp_outer_local(script_ctx_t *ctx)
+{
+    const outer_local_t *outer = get_op_outer_local(ctx, 0);
+    jsval_t copy;
+    unsigned off;
+    HRESULT hres;
+
+    if(!lookup_outer_local(ctx, outer, &off)) {
+        TRACE("%s\n", debugstr_w(outer->name));
+        return identifier_value(ctx, outer->name);
+    }
+
+    hres = jsval_copy(ctx->stack[off], &copy);
+    if(FAILED(hres))
+        return hres;
+
+    TRACE("%s: %s\n", debugstr_w(outer->name), debugstr_jsval(copy));
+    return stack_push(ctx, copy);
+}
+
+static HRESULT interp_outer_local_ref(script_ctx_t *ctx)
+{
+    const outer_local_t *outer = get_op_outer_local(ctx, 0);
+    const unsigned flags = get_op_uint(ctx, 1);
+    exprval_t ref;
+
+    TRACE("%s\n", debugstr_w(outer->name));
+
+    if(!lookup_outer_local(ctx, outer, &ref.u.off))
+        return interp_identifier_ref(ctx, outer->name, flags);
+
+    ref.type = EXPRVAL_STACK_REF;
+    return stack_push_exprval(ctx, &ref);
+}
+
 /* ECMA-262 3rd Edition    10.1.4 */
 static HRESULT interp_ident(script_ctx_t *ctx)
 {
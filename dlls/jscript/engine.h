@@ -56,8 +56,8 @@
     X(lshift,     1, 0,0)                  \
     X(lt,         1, 0,0)                  \
     X(lteq,       1, 0,0)                  \
-    X(member,     1, ARG_BSTR,   0)        \
-    X(memberid,   1, ARG_UINT,   0)        \
+    X(member,     1, ARG_BSTR,   ARG_CACHE)\
+    X(memberid,   1, ARG_UINT,   ARG_CACHE)\
     X(minus,      1, 0,0)                  \
     X(mod,        1, 0,0)                  \
     X(mul,        1, 0,0)                  \
@@ -69,6 +69,8 @@
     X(null,       1, 0,0)                  \
     X(obj_prop,   1, ARG_STR,    ARG_UINT) \
     X(or,         1, 0,0)                  \
+    X(outer_local, 1, ARG_OUTER, 0)        \
+    X(outer_local_ref, 1, ARG_OUTER, ARG_UINT) \
     X(pop,        1, ARG_UINT,   0)        \
     X(pop_except, 0, ARG_ADDR,   0)        \
     X(pop_scope,  1, 0,0)                  \
@@ -109,20 +111,33 @@ OP_LIST
 
 typedef struct _bytecode_t bytecode_t;
 
+#define PROP_CACHE_SIZE 4
+
+/* Property table indices recently seen by a member access instruction, most recent first. */
+typedef struct {
+    unsigned idx[PROP_CACHE_SIZE];
+} prop_cache_t;
+
+typedef struct _outer_local_t outer_local_t;
+
 typedef union {
     BSTR bstr;
     LONG lng;
     jsstr_t *str;
     unsigned uint;
+    prop_cache_t *cache;
+    outer_local_t *outer;
 } instr_arg_t;
 
 typedef enum {
     ARG_NONE = 0,
     ARG_ADDR,
     ARG_BSTR,
+    ARG_CACHE,
     ARG_DBL,
     ARG_FUNC,
     ARG_INT,
+    ARG_OUTER,
     ARG_STR,
     ARG_UINT
 } instr_arg_type_t;
@@ -183,6 +198,14 @@ typedef struct _function_code_t {
     bytecode_t *bytecode;
 } function_code_t;
 
+/* Variable of an enclosing function, resolved at compile time. */
+struct _outer_local_t {
+    BSTR name;
+    const function_code_t *func;
+    unsigned int scope_index;
+    int ref;
+};
+
 IDispatch *lookup_global_host(script_ctx_t*);
 local_ref_t *lookup_local(const function_code_t*,const WCHAR*,unsigned int);
 
@@ -309,5 +332,6 @@ HRESULT exec_source(script_ctx_t*,DWORD,bytecode_t*,function_code_t*,scope_chain
         jsdisp_t*,unsigned,jsval_t*,jsval_t*);
 
 HRESULT create_source_function(script_ctx_t*,bytecode_t*,function_code_t*,scope_chain_t*,jsdisp_t**);
+HRESULT jsdisp_get_id_cached(jsdisp_t*,const WCHAR*,DWORD,prop_cache_t*,DISPID*);
 HRESULT setup_arguments_object(script_ctx_t*,call_frame_t*);
 void detach_arguments_object(call_frame_t*);
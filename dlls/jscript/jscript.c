@@ -80,6 +80,7 @@ void script_release(script_ctx_t *ctx)
     jsval_release(ctx->acc);
     if(ctx->cc)
         release_cc(ctx->cc);
+    release_regexp_cache(ctx);
     heap_pool_free(&ctx->tmp_heap);
     if(ctx->last_match)
         jsstr_release(ctx->last_match);
@@ -132,14 +132,20 @@ struct thread_data {
     LONG thread_id;
 
     BOOL gc_is_unlinking;
-    DWORD gc_last_tick;
+    unsigned int gc_obj_cnt;
+    unsigned int gc_threshold;
 
     struct list objects;
     struct rb_tree weak_refs;
+
+    struct list code_cache;
+    unsigned code_cache_cnt;
+    UINT64 code_cache_saved;
 };
 
 struct thread_data *get_thread_data(void);
 void release_thread_data(struct thread_data*);
+void release_code_cache(struct thread_data*);
 
 typedef struct named_item_t {
     jsdisp_t *script_obj;
@@ -264,6 +270,7 @@ HRESULT disp_delete(IDispatch*,DISPID,BOOL*);
 HRESULT disp_delete_name(script_ctx_t*,IDispatch*,jsstr_t*,BOOL*);
 HRESULT jsdisp_index_lookup(jsdisp_t*,const WCHAR*,unsigned,struct property_info*);
 HRESULT jsdisp_next_index(jsdisp_t*,unsigned,unsigned,struct property_info*);
+BOOL jsdisp_claim_index(jsdisp_t*,unsigned);
 HRESULT jsdisp_delete_idx(jsdisp_t*,DWORD);
 HRESULT jsdisp_get_own_property(jsdisp_t*,const WCHAR*,BOOL,property_desc_t*);
 HRESULT jsdisp_define_property(jsdisp_t*,const WCHAR*,property_desc_t*);
@@ -293,6 +300,7 @@ HRESULT create_object(script_ctx_t*,jsdisp_t*,jsdisp_t**);
 HRESULT create_math(script_ctx_t*,jsdisp_t**);
 HRESULT create_array(script_ctx_t*,DWORD,jsdisp_t**);
 HRESULT create_regexp(script_ctx_t*,jsstr_t*,DWORD,jsdisp_t**);
+void release_regexp_cache(script_ctx_t*);
 HRESULT create_regexp_var(script_ctx_t*,jsval_t,jsval_t*,jsdisp_t**);
 HRESULT create_string(script_ctx_t*,jsstr_t*,jsdisp_t**);
 HRESULT create_bool(script_ctx_t*,BOOL,jsdisp_t**);
@@ -375,6 +383,13 @@ struct weak_refs_entry {
     struct list list;
 };
 
+#define REGEXP_CACHE_SIZE 16
+
+struct regexp_cache_entry {
+    jsstr_t *src;
+    struct regexp_t *regexp;
+};
+
 struct _script_ctx_t {
     LONG ref;
 
@@ -405,6 +420,9 @@ struct _script_ctx_t {
     DWORD last_match_index;
     DWORD last_match_length;
 
+    struct regexp_cache_entry regexp_cache[REGEXP_CACHE_SIZE];
+    unsigned regexp_cache_next;
+
     union {
         struct {
             jsdisp_t *global;
@@ -487,6 +505,9 @@ HRESULT regexp_string_match(script_ctx_t*,jsdisp_t*,jsstr_t*,jsval_t*);
 
 BOOL bool_obj_value(jsdisp_t*);
 unsigned array_get_length(jsdisp_t*);
+HRESULT array_get_elem(jsdisp_t*,DWORD,jsval_t*);
+HRESULT array_set_elem(jsdisp_t*,DWORD,jsval_t);
+HRESULT array_delete_elem(jsdisp_t*,DWORD);
 HRESULT localize_number(script_ctx_t*,DOUBLE,BOOL,jsstr_t**);
 
 BOOL is_builtin_eval_func(jsdisp_t*);
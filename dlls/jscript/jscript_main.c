@@ -58,6 +58,7 @@ struct thread_data *get_thread_data(void)
             return NULL;
         thread_data->thread_id = GetCurrentThreadId();
         list_init(&thread_data->objects);
+        list_init(&thread_data->code_cache);
         rb_init(&thread_data->weak_refs, weak_refs_compare);
         TlsSetValue(jscript_tls, thread_data);
     }
@@ -71,6 +72,7 @@ void release_thread_data(struct thread_data *thread_data)
     if(--thread_data->ref)
         return;
 
+    release_code_cache(thread_data);
     free(thread_data);
     TlsSetValue(jscript_tls, NULL);
 }
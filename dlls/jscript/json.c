@@ -129,40 +129,98 @@ static BOOL unescape_json_string(WCHAR *str, size_t *len)
 }
 
 /* ECMA-262 5.1 Edition    15.12.1.1 */
-static HRESULT parse_json_string(json_parse_ctx_t *ctx, WCHAR **r)
+static HRESULT scan_json_string(json_parse_ctx_t *ctx, const WCHAR **r, size_t *len, BOOL *escaped)
 {
     const WCHAR *ptr = ++ctx->ptr;
-    size_t len;
-    WCHAR *buf;
 
+    *escaped = FALSE;
     while(*ctx->ptr && *ctx->ptr != '"') {
-        if(*ctx->ptr++ == '\\')
+        if(*ctx->ptr++ == '\\' && *ctx->ptr) {
             ctx->ptr++;
+            *escaped = TRUE;
+        }
     }
     if(!*ctx->ptr) {
         FIXME("unterminated string\n");
         return E_FAIL;
     }
 
-    len = ctx->ptr-ptr;
-    buf = malloc((len+1)*sizeof(WCHAR));
-    if(!buf)
-        return E_OUTOFMEMORY;
-    if(len)
-        memcpy(buf, ptr, len*sizeof(WCHAR));
+    *r = ptr;
+    *len = ctx->ptr++ - ptr;
+    return S_OK;
+}
 
-    if(!(ctx->ctx->html_mode ? unescape_json_string(buf, &len) : unescape(buf, &len))) {
+static HRESULT unescape_json(json_parse_ctx_t *ctx, WCHAR *buf, size_t *len)
+{
+    if(!(ctx->ctx->html_mode ? unescape_json_string(buf, len) : unescape(buf, len))) {
         WARN("unescape failed\n");
-        free(buf);
         return JS_E_INVALID_CHAR;
     }
+    return S_OK;
+}
 
-    buf[len] = 0;
-    ctx->ptr++;
-    *r = buf;
+/*
+ * Parses a string into buf if it fits or into a newly allocated buffer otherwise,
+ * the caller frees *r if it's not buf.
+ */
+static HRESULT parse_json_string(json_parse_ctx_t *ctx, WCHAR *buf, size_t buf_size, WCHAR **r)
+{
+    const WCHAR *ptr;
+    BOOL escaped;
+    WCHAR *ret = buf;
+    size_t len;
+    HRESULT hres;
+
+    hres = scan_json_string(ctx, &ptr, &len, &escaped);
+    if(FAILED(hres))
+        return hres;
+
+    if(len >= buf_size && !(ret = malloc((len+1)*sizeof(WCHAR))))
+        return E_OUTOFMEMORY;
+    if(len)
+        memcpy(ret, ptr, len*sizeof(WCHAR));
+
+    if(escaped && FAILED(hres = unescape_json(ctx, ret, &len))) {
+        if(ret != buf)
+            free(ret);
+        return hres;
+    }
+
+    ret[len] = 0;
+    *r = ret;
     return S_OK;
 }
 
+/* Strings without escapes are copied straight from the source into the jsstr_t buffer. */
+static HRESULT parse_json_jsstr(json_parse_ctx_t *ctx, jsstr_t **r)
+{
+    const WCHAR *ptr;
+    BOOL escaped;
+    size_t len;
+    WCHAR *buf;
+    HRESULT hres;
+
+    hres = scan_json_string(ctx, &ptr, &len, &escaped);
+    if(FAILED(hres))
+        return hres;
+
+    if(!escaped) {
+        if(!(*r = jsstr_alloc_len(ptr, len)))
+            return E_OUTOFMEMORY;
+        return S_OK;
+    }
+
+    if(!(buf = malloc(len*sizeof(WCHAR))))
+        return E_OUTOFMEMORY;
+    memcpy(buf, ptr, len*sizeof(WCHAR));
+
+    hres = unescape_json(ctx, buf, &len);
+    if(SUCCEEDED(hres) && !(*r = jsstr_alloc_len(buf, len)))
+        hres = E_OUTOFMEMORY;
+    free(buf);
+    return hres;
+}
+
 /* ECMA-262 5.1 Edition    15.12.1.2 */
 static HRESULT parse_json_value(json_parse_ctx_t *ctx, jsval_t *r)
 {
@@ -191,7 +249,7 @@ static HRESULT parse_json_value(json_parse_ctx_t *ctx, jsval_t *r)
 
     /* JSONObject */
     case '{': {
-        WCHAR *prop_name;
+        WCHAR name_buf[64], *prop_name;
         jsdisp_t *obj;
         jsval_t val;
 
@@ -209,13 +267,14 @@ static HRESULT parse_json_value(json_parse_ctx_t *ctx, jsval_t *r)
         while(1) {
             if(*ctx->ptr != '"')
                 break;
-            hres = parse_json_string(ctx, &prop_name);
+            hres = parse_json_string(ctx, name_buf, ARRAY_SIZE(name_buf), &prop_name);
             if(FAILED(hres))
                 break;
 
             if(skip_spaces(ctx) != ':') {
                 FIXME("missing ':'\n");
-                free(prop_name);
+                if(prop_name != name_buf)
+                    free(prop_name);
                 break;
             }
 
@@ -225,7 +284,8 @@ static HRESULT parse_json_value(json_parse_ctx_t *ctx, jsval_t *r)
                 hres = jsdisp_propput_name(obj, prop_name, val);
                 jsval_release(val);
             }
-            free(prop_name);
+            if(prop_name != name_buf)
+                free(prop_name);
             if(FAILED(hres))
                 break;
 
@@ -248,19 +308,12 @@ static HRESULT parse_json_value(json_parse_ctx_t *ctx, jsval_t *r)
 
     /* JSONString */
     case '"': {
-        WCHAR *string;
         jsstr_t *str;
 
-        hres = parse_json_string(ctx, &string);
+        hres = parse_json_jsstr(ctx, &str);
         if(FAILED(hres))
             return hres;
 
-        /* FIXME: avoid reallocation */
-        str = jsstr_alloc(string);
-        free(string);
-        if(!str)
-            return E_OUTOFMEMORY;
-
         *r = jsval_string(str);
         return S_OK;
     }
@@ -487,6 +540,8 @@ static HRESULT JSON_parse(script_ctx_t *ctx, jsval_t vthis, WORD flags, unsigned
     return S_OK;
 }
 
+#define STRINGIFY_HASH_SIZE 64
+
 typedef struct {
     script_ctx_t *ctx;
 
@@ -494,24 +549,35 @@ typedef struct {
     size_t buf_size;
     size_t buf_len;
 
-    jsdisp_t **stack;
+    struct {
+        jsdisp_t *obj;
+        size_t next;     /* 1-based index of the next entry in the same bucket */
+    } *stack;
     size_t stack_top;
     size_t stack_size;
+    size_t stack_hash[STRINGIFY_HASH_SIZE]; /* 1-based index of the topmost entry in each bucket */
 
     WCHAR gap[11]; /* according to the spec, it's no longer than 10 chars */
 
     jsdisp_t *replacer;
 } stringify_ctx_t;
 
+static inline size_t *stringify_bucket(stringify_ctx_t *ctx, jsdisp_t *obj)
+{
+    return &ctx->stack_hash[((ULONG_PTR)obj >> 4) % STRINGIFY_HASH_SIZE];
+}
+
 static BOOL stringify_push_obj(stringify_ctx_t *ctx, jsdisp_t *obj)
 {
+    size_t *bucket;
+
     if(!ctx->stack_size) {
         ctx->stack = malloc(4*sizeof(*ctx->stack));
         if(!ctx->stack)
             return FALSE;
         ctx->stack_size = 4;
     }else if(ctx->stack_top == ctx->stack_size) {
-        jsdisp_t **new_stack;
+        void *new_stack;
 
         new_stack = realloc(ctx->stack, ctx->stack_size*2*sizeof(*ctx->stack));
         if(!new_stack)
@@ -520,20 +586,26 @@ static BOOL stringify_push_obj(stringify_ctx_t *ctx, jsdisp_t *obj)
         ctx->stack_size *= 2;
     }
 
-    ctx->stack[ctx->stack_top++] = obj;
+    /* The stack is LIFO, so the pushed object always becomes the head of its bucket. */
+    bucket = stringify_bucket(ctx, obj);
+    ctx->stack[ctx->stack_top].obj = obj;
+    ctx->stack[ctx->stack_top].next = *bucket;
+    *bucket = ++ctx->stack_top;
     return TRUE;
 }
 
 static void stringify_pop_obj(stringify_ctx_t *ctx)
 {
     ctx->stack_top--;
+    *stringify_bucket(ctx, ctx->stack[ctx->stack_top].obj) = ctx->stack[ctx->stack_top].next;
 }
 
 static BOOL is_on_stack(stringify_ctx_t *ctx, jsdisp_t *obj)
 {
-    size_t i = ctx->stack_top;
-    while(i--) {
-        if(ctx->stack[i] == obj)
+    size_t i;
+
+    for(i = *stringify_bucket(ctx, obj); i; i = ctx->stack[i - 1].next) {
+        if(ctx->stack[i - 1].obj == obj)
             return TRUE;
     }
     return FALSE;
@@ -571,6 +643,10 @@ static inline BOOL append_string(stringify_ctx_t *ctx, const WCHAR *str)
 
 static inline BOOL append_char(stringify_ctx_t *ctx, WCHAR c)
 {
+    if(ctx->buf_len < ctx->buf_size) {
+        ctx->buf[ctx->buf_len++] = c;
+        return TRUE;
+    }
     return append_string_len(ctx, &c, 1);
 }
 
@@ -616,13 +692,20 @@ static HRESULT maybe_to_primitive(script_ctx_t *ctx, jsval_t val, jsval_t *r)
     return S_OK;
 }
 
-/* ECMA-262 5.1 Edition    15.12.3 (abstract operation Quote) */
-static HRESULT json_quote(stringify_ctx_t *ctx, const WCHAR *ptr, size_t len)
+static HRESULT json_quote_chars(stringify_ctx_t *ctx, const WCHAR *ptr, size_t len)
 {
-    if(!ptr || !append_char(ctx, '"'))
-        return E_OUTOFMEMORY;
+    const WCHAR *end = ptr + len, *run = ptr;
+    WCHAR buf[7];
+
+    /* Characters that don't need escaping are appended in runs. */
+    for(; ptr < end; ptr++) {
+        if(*ptr >= ' ' && *ptr != '"' && *ptr != '\\')
+            continue;
+
+        if(ptr > run && !append_string_len(ctx, run, ptr - run))
+            return E_OUTOFMEMORY;
+        run = ptr + 1;
 
-    while(len--) {
         switch(*ptr) {
         case '"':
         case '\\':
@@ -650,19 +733,48 @@ static HRESULT json_quote(stringify_ctx_t *ctx, const WCHAR *ptr, size_t len)
                 return E_OUTOFMEMORY;
             break;
         default:
-            if(*ptr < ' ') {
-                WCHAR buf[7];
-                swprintf(buf, ARRAY_SIZE(buf), L"\\u%04x", *ptr);
-                if(!append_string(ctx, buf))
-                    return E_OUTOFMEMORY;
-            }else {
-                if(!append_char(ctx, *ptr))
-                    return E_OUTOFMEMORY;
-            }
+            swprintf(buf, ARRAY_SIZE(buf), L"\\u%04x", *ptr);
+            if(!append_string(ctx, buf))
+                return E_OUTOFMEMORY;
         }
-        ptr++;
     }
 
+    if(ptr > run && !append_string_len(ctx, run, ptr - run))
+        return E_OUTOFMEMORY;
+    return S_OK;
+}
+
+/* Ropes are quoted piece by piece instead of being flattened. */
+static HRESULT json_quote_jsstr(stringify_ctx_t *ctx, jsstr_t *str)
+{
+    const WCHAR *ptr;
+    HRESULT hres;
+
+    if(jsstr_is_rope(str)) {
+        jsstr_rope_t *rope = jsstr_as_rope(str);
+
+        hres = json_quote_jsstr(ctx, rope->left);
+        if(FAILED(hres))
+            return hres;
+        return json_quote_jsstr(ctx, rope->right);
+    }
+
+    ptr = jsstr_flatten(str);
+    return ptr ? json_quote_chars(ctx, ptr, jsstr_length(str)) : E_OUTOFMEMORY;
+}
+
+/* ECMA-262 5.1 Edition    15.12.3 (abstract operation Quote) */
+static HRESULT json_quote(stringify_ctx_t *ctx, jsstr_t *str)
+{
+    HRESULT hres;
+
+    if(!append_char(ctx, '"'))
+        return E_OUTOFMEMORY;
+
+    hres = json_quote_jsstr(ctx, str);
+    if(FAILED(hres))
+        return hres;
+
     return append_char(ctx, '"') ? S_OK : E_OUTOFMEMORY;
 }
 
@@ -671,13 +783,15 @@ static inline BOOL is_callable(jsdisp_t *obj)
     return is_class(obj, JSCLASS_FUNCTION);
 }
 
-static HRESULT stringify(stringify_ctx_t *ctx, jsdisp_t *object, const WCHAR *name);
+static HRESULT stringify(stringify_ctx_t *ctx, jsdisp_t *object, jsstr_t *name, jsval_t value);
 
 /* ECMA-262 5.1 Edition    15.12.3 (abstract operation JA) */
 static HRESULT stringify_array(stringify_ctx_t *ctx, jsdisp_t *obj)
 {
     unsigned length, i, j;
-    WCHAR name[16];
+    jsstr_t *name = NULL;
+    WCHAR buf[12];
+    jsval_t value;
     HRESULT hres;
 
     if(is_on_stack(ctx, obj)) {
@@ -707,8 +821,24 @@ static HRESULT stringify_array(stringify_ctx_t *ctx, jsdisp_t *obj)
             }
         }
 
-        _itow(i, name, ARRAY_SIZE(name));
-        hres = stringify(ctx, obj, name);
+        hres = jsdisp_get_idx(obj, i, &value);
+        if(hres == DISP_E_UNKNOWNNAME)
+            value = jsval_undefined();
+        else if(FAILED(hres))
+            return hres;
+
+        /* The name is only needed for the replacer. */
+        if(ctx->replacer) {
+            swprintf(buf, ARRAY_SIZE(buf), L"%u", i);
+            if(!(name = jsstr_alloc(buf))) {
+                jsval_release(value);
+                return E_OUTOFMEMORY;
+            }
+        }
+
+        hres = stringify(ctx, obj, name, value);
+        if(name)
+            jsstr_release(name);
         if(FAILED(hres))
             return hres;
         if(hres == S_FALSE && !append_string(ctx, L"null"))
@@ -727,8 +857,10 @@ static HRESULT stringify_object(stringify_ctx_t *ctx, jsdisp_t *obj)
 {
     DISPID dispid = DISPID_STARTENUM;
     unsigned prop_cnt = 0, i;
+    const WCHAR *name;
     size_t stepback;
-    BSTR prop_name;
+    jsstr_t *prop_name;
+    jsval_t value;
     HRESULT hres;
 
     if(is_on_stack(ctx, obj)) {
@@ -742,7 +874,7 @@ static HRESULT stringify_object(stringify_ctx_t *ctx, jsdisp_t *obj)
     if(!append_char(ctx, '{'))
         return E_OUTOFMEMORY;
 
-    while((hres = IDispatchEx_GetNextDispID(to_dispex(obj), fdexEnumDefault, dispid, &dispid)) == S_OK) {
+    while((hres = jsdisp_next_prop(obj, dispid, JSDISP_ENUM_ALL, &dispid)) == S_OK) {
         stepback = ctx->buf_len;
 
         if(prop_cnt && !append_char(ctx, ',')) {
@@ -764,23 +896,32 @@ static HRESULT stringify_object(stringify_ctx_t *ctx, jsdisp_t *obj)
             }
         }
 
-        hres = IDispatchEx_GetMemberName(to_dispex(obj), dispid, &prop_name);
+        hres = jsdisp_get_prop_name(obj, dispid, &prop_name);
         if(FAILED(hres))
             return hres;
 
-        hres = json_quote(ctx, prop_name, SysStringLen(prop_name));
+        hres = json_quote(ctx, prop_name);
         if(FAILED(hres)) {
-            SysFreeString(prop_name);
+            jsstr_release(prop_name);
             return hres;
         }
 
         if(!append_char(ctx, ':') || (*ctx->gap && !append_char(ctx, ' '))) {
-            SysFreeString(prop_name);
+            jsstr_release(prop_name);
             return E_OUTOFMEMORY;
         }
 
-        hres = stringify(ctx, obj, prop_name);
-        SysFreeString(prop_name);
+        if(!(name = jsstr_flatten(prop_name))) {
+            jsstr_release(prop_name);
+            return E_OUTOFMEMORY;
+        }
+
+        hres = jsdisp_propget_name(obj, name, &value);
+        if(SUCCEEDED(hres))
+            hres = stringify(ctx, obj, prop_name, value);
+        else if(hres == DISP_E_UNKNOWNNAME)
+            hres = S_FALSE;
+        jsstr_release(prop_name);
         if(FAILED(hres))
             return hres;
 
@@ -791,6 +932,8 @@ static HRESULT stringify_object(stringify_ctx_t *ctx, jsdisp_t *obj)
 
         prop_cnt++;
     }
+    if(FAILED(hres))
+        return hres;
 
     if(prop_cnt && *ctx->gap) {
         if(!append_char(ctx, '\n'))
@@ -812,15 +955,11 @@ static HRESULT stringify_object(stringify_ctx_t *ctx, jsdisp_t *obj)
 }
 
 /* ECMA-262 5.1 Edition    15.12.3 (abstract operation Str) */
-static HRESULT stringify(stringify_ctx_t *ctx, jsdisp_t *object, const WCHAR *name)
+static HRESULT stringify(stringify_ctx_t *ctx, jsdisp_t *object, jsstr_t *name, jsval_t value)
 {
-    jsval_t value, v;
+    jsval_t v;
     HRESULT hres;
 
-    hres = jsdisp_propget_name(object, name, &value);
-    if(FAILED(hres))
-        return hres == DISP_E_UNKNOWNNAME ? S_FALSE : hres;
-
     if(is_object_instance(value)) {
         jsdisp_t *obj;
         DISPID id;
@@ -837,16 +976,10 @@ static HRESULT stringify(stringify_ctx_t *ctx, jsdisp_t *object, const WCHAR *na
     }
 
     if(ctx->replacer) {
-        jsstr_t *name_str;
         jsval_t args[2];
-        if(!(name_str = jsstr_alloc(name))) {
-            jsval_release(value);
-            return E_OUTOFMEMORY;
-        }
-        args[0] = jsval_string(name_str);
+        args[0] = jsval_string(name);
         args[1] = value;
         hres = jsdisp_call_value(ctx->replacer, jsval_obj(object), DISPATCH_METHOD, ARRAY_SIZE(args), args, &v);
-        jsstr_release(name_str);
         jsval_release(value);
         if(FAILED(hres))
             return hres;
@@ -870,18 +1003,18 @@ static HRESULT stringify(stringify_ctx_t *ctx, jsdisp_t *object, const WCHAR *na
         if(!append_string(ctx, get_bool(value) ? L"true" : L"false"))
             hres = E_OUTOFMEMORY;
         break;
-    case JSV_STRING: {
-        jsstr_t *str = get_string(value);
-        const WCHAR *ptr = jsstr_flatten(str);
-        if(ptr)
-            hres = json_quote(ctx, ptr, jsstr_length(str));
-        else
-            hres = E_OUTOFMEMORY;
+    case JSV_STRING:
+        hres = json_quote(ctx, get_string(value));
         break;
-    }
     case JSV_NUMBER: {
         double n = get_number(value);
-        if(isfinite(n)) {
+        if(n >= INT_MIN && n <= INT_MAX && n == (int)n) {
+            WCHAR buf[12];
+
+            _itow((int)n, buf, 10);
+            if(!append_string(ctx, buf))
+                hres = E_OUTOFMEMORY;
+        }else if(isfinite(n)) {
             const WCHAR *ptr;
             jsstr_t *str;
 
@@ -935,6 +1068,8 @@ static HRESULT JSON_stringify(script_ctx_t *ctx, jsval_t vthis, WORD flags, unsi
 {
     stringify_ctx_t stringify_ctx = { ctx };
     jsdisp_t *obj = NULL, *replacer;
+    jsstr_t *name;
+    jsval_t value;
     HRESULT hres;
 
     TRACE("\n");
@@ -988,7 +1123,12 @@ static HRESULT JSON_stringify(script_ctx_t *ctx, jsval_t vthis, WORD flags, unsi
     if(FAILED(hres = jsdisp_propput_name(obj, L"", argv[0])))
         goto fail;
 
-    hres = stringify(&stringify_ctx, obj, L"");
+    if(FAILED(hres = jsval_copy(argv[0], &value)))
+        goto fail;
+
+    name = jsstr_empty();
+    hres = stringify(&stringify_ctx, obj, name, value);
+    jsstr_release(name);
     if(SUCCEEDED(hres) && r) {
         assert(!stringify_ctx.stack_top);
 
@@ -550,7 +550,7 @@ static void RegExp_destructor(jsdisp_t *dispex)
     RegExpInstance *This = regexp_from_jsdisp(dispex);
 
     if(This->jsregexp)
-        regexp_destroy(This->jsregexp);
+        regexp_release(This->jsregexp);
     jsval_release(This->last_index_val);
     jsstr_release(This->str);
 }
@@ -623,29 +623,81 @@ static HRESULT alloc_regexp(script_ctx_t *ctx, jsstr_t *str, jsdisp_t *object_pr
     return S_OK;
 }
 
-HRESULT create_regexp(script_ctx_t *ctx, jsstr_t *src, DWORD flags, jsdisp_t **ret)
+/*
+ * Compiled regexps are immutable, so objects created from the same source and flags
+ * (like a literal evaluated in a loop) share them. The cached source string is
+ * returned in src, because the compiled regexp points to its buffer.
+ */
+static HRESULT compile_regexp(script_ctx_t *ctx, jsstr_t **src, DWORD flags, regexp_t **ret)
 {
-    RegExpInstance *regexp;
+    struct regexp_cache_entry *entry;
     const WCHAR *str;
-    HRESULT hres;
+    regexp_t *re;
+    unsigned i;
+
+    for(i = 0; i < ARRAY_SIZE(ctx->regexp_cache); i++) {
+        entry = &ctx->regexp_cache[i];
+        if(entry->regexp && entry->regexp->flags == flags && jsstr_eq(entry->src, *src)) {
+            *src = entry->src;
+            *ret = regexp_addref(entry->regexp);
+            return S_OK;
+        }
+    }
 
-    str = jsstr_flatten(src);
+    str = jsstr_flatten(*src);
     if(!str)
         return E_OUTOFMEMORY;
 
-    TRACE("%s %lx\n", debugstr_wn(str, jsstr_length(src)), flags);
+    TRACE("%s %lx\n", debugstr_wn(str, jsstr_length(*src)), flags);
 
-    hres = alloc_regexp(ctx, src, NULL, &regexp);
+    re = regexp_new(ctx, &ctx->tmp_heap, str, jsstr_length(*src), flags, FALSE);
+    if(!re) {
+        WARN("regexp_new failed\n");
+        return DISP_E_EXCEPTION;
+    }
+
+    entry = &ctx->regexp_cache[ctx->regexp_cache_next++ % ARRAY_SIZE(ctx->regexp_cache)];
+    if(entry->regexp) {
+        regexp_release(entry->regexp);
+        jsstr_release(entry->src);
+    }
+    entry->src = jsstr_addref(*src);
+    entry->regexp = regexp_addref(re);
+
+    *ret = re;
+    return S_OK;
+}
+
+void release_regexp_cache(script_ctx_t *ctx)
+{
+    unsigned i;
+
+    for(i = 0; i < ARRAY_SIZE(ctx->regexp_cache); i++) {
+        if(ctx->regexp_cache[i].regexp) {
+            regexp_release(ctx->regexp_cache[i].regexp);
+            jsstr_release(ctx->regexp_cache[i].src);
+            ctx->regexp_cache[i].regexp = NULL;
+        }
+    }
+}
+
+HRESULT create_regexp(script_ctx_t *ctx, jsstr_t *src, DWORD flags, jsdisp_t **ret)
+{
+    RegExpInstance *regexp;
+    regexp_t *re;
+    HRESULT hres;
+
+    hres = compile_regexp(ctx, &src, flags, &re);
     if(FAILED(hres))
         return hres;
 
-    regexp->jsregexp = regexp_new(ctx, &ctx->tmp_heap, str, jsstr_length(regexp->str), flags, FALSE);
-    if(!regexp->jsregexp) {
-        WARN("regexp_new failed\n");
-        jsdisp_release(&regexp->dispex);
-        return DISP_E_EXCEPTION;
+    hres = alloc_regexp(ctx, src, NULL, &regexp);
+    if(FAILED(hres)) {
+        regexp_release(re);
+        return hres;
     }
 
+    regexp->jsregexp = re;
     *ret = &regexp->dispex;
     return S_OK;
 }
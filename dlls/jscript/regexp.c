@@ -32,6 +32,7 @@
  */
 
 #include <assert.h>
+#include <wchar.h>
 
 #include "jscript.h"
 #include "regexp.h"
@@ -3067,6 +3068,48 @@ good:
     return x;
 }
 
+/*
+ * Return the first position at or after cp where the literal or character
+ * class every match starts with can be found, or NULL if there's none.
+ */
+static const WCHAR *
+FindMatchStart(REGlobalData *gData, const WCHAR *cp)
+{
+    const regexp_t *re = gData->regexp;
+    size_t avail = gData->cpend - cp, pos, last;
+    const RECharSet *charSet;
+    WCHAR ch;
+
+    if (re->prefilter == REOP_CLASS) {
+        charSet = &re->classList[re->prefix_class];
+        assert(charSet->converted);
+        if (charSet->length == 0)
+            return NULL;
+        for (; cp != gData->cpend; cp++) {
+            ch = *cp;
+            if (ch <= charSet->length &&
+                (charSet->u.bits[ch >> 3] & (1 << (ch & 0x7))))
+                return cp;
+        }
+        return NULL;
+    }
+
+    assert(re->prefilter == REOP_FLAT);
+    if (re->prefix_len == 1)
+        return wmemchr(cp, re->prefix[0], avail);
+    if (re->prefix_len > avail)
+        return NULL;
+
+    last = re->prefix_len - 1;
+    for (pos = 0; pos <= avail - re->prefix_len;
+         pos += re->prefix_skip[cp[pos + last] & 0xff]) {
+        if (cp[pos + last] == re->prefix[last] &&
+            !memcmp(cp + pos, re->prefix, last * sizeof(WCHAR)))
+            return cp + pos;
+    }
+    return NULL;
+}
+
 static match_state_t *MatchRegExp(REGlobalData *gData, match_state_t *x)
 {
     match_state_t *result;
@@ -3079,6 +3122,11 @@ static match_state_t *MatchRegExp(REGlobalData *gData, match_state_t *x)
      * in order to detect end-of-input/line condition.
      */
     for (cp2 = cp; cp2 <= gData->cpend; cp2++) {
+        if (gData->regexp->prefilter != REOP_EMPTY) {
+            cp2 = FindMatchStart(gData, cp2);
+            if (!cp2)
+                return NULL;
+        }
         gData->skipped = cp2 - cp;
         x->cp = cp2;
         for (j = 0; j < gData->regexp->parenCount; j++)
@@ -3174,8 +3222,11 @@ HRESULT regexp_execute(regexp_t *regexp, void *cx, heap_pool_t *pool,
     return S_OK;
 }
 
-void regexp_destroy(regexp_t *re)
+void regexp_release(regexp_t *re)
 {
+    if (--re->ref)
+        return;
+
     if (re->classList) {
         UINT i;
         for (i = 0; i < re->classCount; i++) {
@@ -3188,6 +3239,61 @@ void regexp_destroy(regexp_t *re)
     free(re);
 }
 
+/*
+ * Find a literal or a character class every match has to start with, so that
+ * MatchRegExp can skip input positions without running the bytecode.
+ */
+static void
+InitPrefilter(regexp_t *re)
+{
+    jsbytecode *pc = re->program;
+    size_t index, length, i;
+    REOp op;
+
+    re->prefilter = REOP_EMPTY;
+    if (re->flags & REG_STICKY)
+        return;
+
+    /* Skip over the zero-width ops that can't make the first term optional. */
+    for (;;) {
+        op = (REOp) *pc++;
+        if (op == REOP_LPAREN)
+            pc = ReadCompactIndex(pc, &index);
+        else if (op != REOP_BOL)
+            break;
+    }
+
+    switch (op) {
+      case REOP_FLAT:
+        pc = ReadCompactIndex(pc, &index);
+        ReadCompactIndex(pc, &length);
+        re->prefix = re->source + index;
+        re->prefix_len = length;
+        break;
+      case REOP_FLAT1:
+        re->prefix_chr = *pc;
+        re->prefix = &re->prefix_chr;
+        re->prefix_len = 1;
+        break;
+      case REOP_UCFLAT1:
+        re->prefix_chr = GET_ARG(pc);
+        re->prefix = &re->prefix_chr;
+        re->prefix_len = 1;
+        break;
+      case REOP_CLASS:
+        ReadCompactIndex(pc, &re->prefix_class);
+        re->prefilter = REOP_CLASS;
+        return;
+      default:
+        return;
+    }
+
+    re->prefilter = REOP_FLAT;
+    memset(re->prefix_skip, min(re->prefix_len, 0xff), sizeof(re->prefix_skip));
+    for (i = 0; i + 1 < re->prefix_len; i++)
+        re->prefix_skip[re->prefix[i] & 0xff] = min(re->prefix_len - 1 - i, 0xff);
+}
+
 regexp_t* regexp_new(void *cx, heap_pool_t *pool, const WCHAR *str,
         DWORD str_len, WORD flags, BOOL flat)
 {
@@ -3237,13 +3343,14 @@ regexp_t* regexp_new(void *cx, heap_pool_t *pool, const WCHAR *str,
     re = malloc(resize);
     if (!re)
         goto out;
+    re->ref = 1;
 
     assert(state.classBitmapsMem <= CLASS_BITMAPS_MEM_LIMIT);
     re->classCount = state.classCount;
     if (re->classCount) {
         re->classList = malloc(re->classCount * sizeof(RECharSet));
         if (!re->classList) {
-            regexp_destroy(re);
+            regexp_release(re);
             re = NULL;
             goto out;
         }
@@ -3254,7 +3361,7 @@ regexp_t* regexp_new(void *cx, heap_pool_t *pool, const WCHAR *str,
     }
     endPC = EmitREBytecode(&state, re, state.treeDepth, re->program, state.result);
     if (!endPC) {
-        regexp_destroy(re);
+        regexp_release(re);
         re = NULL;
         goto out;
     }
@@ -3277,6 +3384,7 @@ regexp_t* regexp_new(void *cx, heap_pool_t *pool, const WCHAR *str,
     re->parenCount = state.parenCount;
     re->source = str;
     re->source_len = str_len;
+    InitPrefilter(re);
 
 out:
     heap_pool_clear(mark);
@@ -58,14 +58,27 @@ typedef struct regexp_t {
     struct RECharSet    *classList;    /* list of [...] bitmaps */
     const WCHAR         *source;       /* locked source string, sans // */
     DWORD               source_len;
+    LONG                ref;
+    BYTE                prefilter;     /* REOP_FLAT or REOP_CLASS if every match starts with one */
+    WCHAR               prefix_chr;    /* storage for a single character prefix */
+    const WCHAR         *prefix;       /* literal every match starts with */
+    size_t              prefix_len;
+    size_t              prefix_class;  /* index of the class every match starts with */
+    BYTE                prefix_skip[256]; /* Horspool shift table for prefix */
     jsbytecode          program[1];    /* regular expression bytecode */
 } regexp_t;
 
 regexp_t* regexp_new(void*, heap_pool_t*, const WCHAR*, DWORD, WORD, BOOL);
-void regexp_destroy(regexp_t*);
+void regexp_release(regexp_t*);
 HRESULT regexp_execute(regexp_t*, void*, heap_pool_t*, const WCHAR*,
         DWORD, match_state_t*);
 
+static inline regexp_t *regexp_addref(regexp_t *regexp)
+{
+    regexp->ref++;
+    return regexp;
+}
+
 static inline match_state_t* alloc_match_state(regexp_t *regexp,
         heap_pool_t *pool, const WCHAR *pos)
 {
@@ -1340,6 +1340,51 @@ tmp = arr.splice(2, -bigInt);
 ok(tmp.toString() == "", "arr.splice(2, -bigInt) returned " + tmp.toString());
 ok(arr.toString() == "1,2,3,4,5", "arr.splice(2, -bigInt) is " + arr.toString());
 
+arr = [1,2,3,4,5];
+delete arr[1];
+ok(arr.length === 5, "arr.length = " + arr.length);
+ok(!(1 in arr), "arr[1] not deleted");
+ok(arr[2] === 3 && arr[4] === 5, "arr = " + arr);
+arr[1] = "a";
+arr.push(6);
+ok(arr.join() === "1,a,3,4,5,6", "arr = " + arr);
+arr.length = 2;
+ok(arr.toString() === "1,a", "arr = " + arr);
+ok(arr[2] === undefined, "arr[2] = " + arr[2]);
+arr[3] = 4;
+ok(arr.toString() === "1,a,,4", "arr = " + arr);
+arr[2] = 3;
+ok(arr.toString() === "1,a,3,4", "arr = " + arr);
+tmp = arr.shift();
+ok(tmp === 1, "shift() = " + tmp);
+ok(arr.toString() === "a,3,4", "arr = " + arr);
+arr.unshift(5, 6);
+ok(arr.toString() === "5,6,a,3,4", "arr = " + arr);
+tmp = arr.splice(1, 3, "b");
+ok(tmp.toString() === "6,a,3", "splice() returned " + tmp);
+ok(arr.toString() === "5,b,4", "arr = " + arr);
+ok(arr.indexOf(4) === 2, "arr.indexOf(4) = " + arr.indexOf(4));
+arr.sort();
+ok(arr.toString() === "4,5,b", "arr = " + arr);
+tmp = 0;
+for(i in arr)
+    tmp++;
+ok(tmp === 3, "enumerated " + tmp + " elements");
+
+Array.prototype[3] = "proto";
+arr = [1,2,3];
+ok(arr[3] === "proto", "arr[3] = " + arr[3]);
+arr.unshift(0);
+ok(arr["3"] === 3, "arr[\"3\"] = " + arr["3"]);
+ok(arr.hasOwnProperty("3"), "arr[3] is not an own property");
+arr = [1,2,3];
+ok(arr["3"] === "proto", "arr[\"3\"] = " + arr["3"]);
+arr.splice(1, 0, "a");
+ok(arr["3"] === 3, "arr[\"3\"] = " + arr["3"]);
+ok(arr.hasOwnProperty("3"), "arr[3] is not an own property");
+ok(arr.toString() === "1,a,2,3", "arr = " + arr);
+delete Array.prototype[3];
+
 obj = new Object();
 obj.length = 3;
 obj[0] = 1;
@@ -1965,7 +2010,13 @@ ok(isNaN(tmp), "Math.tan(-Infinity) is not NaN");
                 "{\n  \"prop1\": true,\n  \"prop2\": {\n    \"prop\": \"string\"\n  }\n}"],
         [[{ },undefined," "], "{}"],
         [[[,2,undefined,3,{ },]],"[null,2,null,3,{},null]"],
-        [[[,2,undefined,3,{prop:0},],undefined,"  "],"[\n  null,\n  2,\n  null,\n  3,\n  {\n    \"prop\": 0\n  },\n  null\n]"]
+        [[[,2,undefined,3,{prop:0},],undefined,"  "],"[\n  null,\n  2,\n  null,\n  3,\n  {\n    \"prop\": 0\n  },\n  null\n]"],
+        [[[0,1,2,3,4,5,6,7,8,9,10,11]], "[0,1,2,3,4,5,6,7,8,9,10,11]"],
+        [[[0,1,2,3,4,5,6,7,8,9,10,[16,17,18,19,20,21,22,23,24,25,26]]],
+         "[0,1,2,3,4,5,6,7,8,9,10,[16,17,18,19,20,21,22,23,24,25,26]]"],
+        [[[1.5,-0,2147483648,-2147483648]], "[1.5,0,2147483648,-2147483648]"],
+        [["a\"b\\c\u0001d\te"], "\"a\\\"b\\\\c\\u0001d\\te\""],
+        [[(function() { var o = {x:1}; return {a:o,b:[o]}; })()], "{\"a\":{\"x\":1},\"b\":[{\"x\":1}]}"]
     ];
 
     var i, s, v, t;
@@ -2006,6 +2057,17 @@ ok(isNaN(tmp), "Math.tan(-Infinity) is not NaN");
     });
     ok(s == "{\"prop\":1}", "s = " + s);
 
+    var names = [];
+    s = JSON.stringify([0,1,2,3,4,5,6,7,8,9,10,11], function(name, value) {
+        if(name !== "") {
+            ok(this[name] === value, "this[" + name + "] = " + this[name] + " expected " + value);
+            names.push(name);
+        }
+        return value;
+    });
+    ok(s === "[0,1,2,3,4,5,6,7,8,9,10,11]", "s = " + s);
+    ok(names.join() === "0,1,2,3,4,5,6,7,8,9,10,11", "names = " + names.join());
+
     var parse_tests = [
         ["true", true],
         ["   \nnull  ", null],
@@ -2052,6 +2114,21 @@ ok(isNaN(tmp), "Math.tan(-Infinity) is not NaN");
         ok(json_cmp(v, parse_tests[i][1]), "parse[" + i + "] returned " + v + ", expected " + parse_tests[i][1]);
     }
 
+    s = "";
+    for(i = 0; i < 100; i++)
+        s += "x";
+    v = JSON.parse("{\"" + s + "\":1,\"a\\u0062\":2}");
+    ok(v[s] === 1, "v[s] = " + v[s]);
+    ok(v.ab === 2, "v.ab = " + v.ab);
+
+    v = JSON.parse("\"\\u0000d\"");
+    ok(v === "\u0000d", "v.length = " + v.length);
+
+    try {
+        JSON.parse("\"\\");
+        ok(false, "expected exception for a string ending with a backslash");
+    }catch(e) {}
+
     v = [ [-1, "b"], {"length": -2, "0": -4, "1": -5}, [{}], [{"x": [null]}] ];
     s =
     '{' +
@@ -2096,6 +2096,95 @@ function returnTest() {
 
 ok(returnTest() === undefined, "returnTest = " + returnTest());
 
+function testMemberCache() {
+    function Point(x, y) { this.x = x; this.y = y; }
+    Point.prototype.sum = function() { return this.x + this.y; };
+
+    function getY(o) { return o.y; }
+    function callSum(o) { return o.sum(); }
+
+    var objs = [new Point(1, 2), {y: 3}, {a: 0, y: 4}, {b: 0, c: 0, y: 5}, {d: 0, e: 0, f: 0, y: 6}, {}];
+    var i, r, o;
+
+    for(r = 0; r < 2; r++) {
+        for(i = 0; i < objs.length - 1; i++)
+            ok(getY(objs[i]) === i + 2, "getY(objs[" + i + "]) = " + getY(objs[i]));
+        ok(getY(objs[i]) === undefined, "getY({}) = " + getY(objs[i]));
+    }
+
+    o = new Point(3, 4);
+    ok(callSum(o) === 7, "callSum(o) = " + callSum(o));
+    o.sum = function() { return 1; };
+    ok(callSum(o) === 1, "callSum(o) with own sum = " + callSum(o));
+    delete o.sum;
+    ok(callSum(o) === 7, "callSum(o) after delete = " + callSum(o));
+    Point.prototype.sum = function() { return this.x * this.y; };
+    ok(callSum(o) === 12, "callSum(o) with new prototype sum = " + callSum(o));
+
+    o = new Point(1, 2);
+    delete o.y;
+    ok(getY(o) === undefined, "getY(o) after delete = " + getY(o));
+    Point.prototype.y = 10;
+    ok(getY(o) === 10, "getY(o) from prototype = " + getY(o));
+    o.y = 11;
+    ok(getY(o) === 11, "getY(o) after set = " + getY(o));
+    delete Point.prototype.y;
+
+    for(i = 0; i < objs.length; i++)
+        objs[i].z = i;
+    for(i = 0; i < objs.length; i++)
+        ok(objs[i].z === i, "objs[" + i + "].z = " + objs[i].z);
+}
+
+testMemberCache();
+
+function testOuterLocals() {
+    var x = 1, y = "outer", i, r;
+
+    function inner() { return x; }
+    function setInner(v) { x = v; }
+
+    ok(inner() === 1, "inner() = " + inner());
+    setInner(2);
+    ok(x === 2, "x = " + x);
+    ok(inner() === 2, "inner() = " + inner());
+
+    r = 0;
+    for(i = 0; i < 10; i++)
+        (function() { r += x; })();
+    ok(r === 20, "r = " + r);
+
+    with({y: "with"}) {
+        r = (function() { return y; })();
+        ok(r === "with", "y in with = " + r);
+    }
+
+    try {
+        throw "catch";
+    }catch(y) {
+        r = (function() { return y; })();
+        ok(r === "catch", "y in catch = " + r);
+    }
+
+    (function() {
+        eval("var y = 'eval';");
+        r = (function() { return y; })();
+        ok(r === "eval", "y after eval = " + r);
+    })();
+
+    r = (function(y) { return (function() { return y; })(); })("param");
+    ok(r === "param", "y param = " + r);
+
+    r = (function() { return function() { return x + y; }; })();
+    x = 3;
+    ok(r() === "3outer", "r() = " + r());
+
+    ok(y === "outer", "y = " + y);
+    return function() { return y; };
+}
+
+ok(testOuterLocals()() === "outer", "detached y = " + testOuterLocals()());
+
 ActiveXObject = 1;
 ok(ActiveXObject === 1, "ActiveXObject = " + ActiveXObject);
 
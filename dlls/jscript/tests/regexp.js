@@ -768,4 +768,34 @@ ok(re.ignoreCase === false, "re.ignoreCase = " + re.ignoreCase);
 ok(re.multiline === true, "re.multiline = " + re.multiline);
 ok(re.global === true, "re.global = " + re.global);
 
+m = "abcabdabcabe".match(/abcabe/);
+ok(m.index === 6, "m.index = " + m.index);
+ok(m[0] === "abcabe", "m[0] = " + m[0]);
+
+m = "xaxbxaxbc".match(/(xa)xbc/);
+ok(m.index === 4, "m.index = " + m.index);
+ok(m[1] === "xa", "m[1] = " + m[1]);
+
+m = "x\nab".match(/^ab/m);
+ok(m.index === 2, "m.index = " + m.index);
+ok("x\nab".match(/^ab/) === null, "/^ab/ matched");
+
+m = "abc123def".match(/[0-9]+/);
+ok(m.index === 3, "m.index = " + m.index);
+ok(m[0] === "123", "m[0] = " + m[0]);
+ok("abc".match(/[0-9]/) === null, "/[0-9]/ matched");
+ok("abab".match(/abb/) === null, "/abb/ matched");
+
+for(i = 0; i < 3; i++) {
+    re = new RegExp("a\u0100b", "g");
+    ok(re.lastIndex === 0, "re.lastIndex = " + re.lastIndex);
+    m = re.exec("xa\u0100ba\u0100b");
+    ok(m.index === 1, "m.index = " + m.index);
+    ok(re.lastIndex === 4, "re.lastIndex = " + re.lastIndex);
+}
+
+re = new RegExp("ab", "i");
+ok("xAB".search(re) === 1, "xAB.search(re) = " + "xAB".search(re));
+ok("xAB".search(new RegExp("ab")) === -1, "xAB.search(new RegExp(ab)) = " + "xAB".search(new RegExp("ab")));
+
 reportSuccess();
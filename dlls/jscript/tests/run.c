@@ -2217,6 +2217,79 @@ static HRESULT parse_script(DWORD flags, const WCHAR *script_str)
     return hres;
 }
 
+static IActiveScript *parse_script_in_new_engine(const WCHAR *script_str)
+{
+    IActiveScriptParse *parser;
+    IActiveScript *engine;
+    HRESULT hres;
+
+    engine = create_script();
+    if(!engine)
+        return NULL;
+
+    hres = IActiveScript_QueryInterface(engine, &IID_IActiveScriptParse, (void**)&parser);
+    ok(hres == S_OK, "Could not get IActiveScriptParse: %08lx\n", hres);
+
+    hres = IActiveScriptParse_InitNew(parser);
+    ok(hres == S_OK, "InitNew failed: %08lx\n", hres);
+
+    hres = IActiveScript_SetScriptSite(engine, &ActiveScriptSite);
+    ok(hres == S_OK, "SetScriptSite failed: %08lx\n", hres);
+
+    hres = IActiveScript_AddNamedItem(engine, L"test", SCRIPTITEM_ISVISIBLE|SCRIPTITEM_ISSOURCE);
+    ok(hres == S_OK, "AddNamedItem failed: %08lx\n", hres);
+
+    hres = IActiveScript_SetScriptState(engine, SCRIPTSTATE_STARTED);
+    ok(hres == S_OK, "SetScriptState(SCRIPTSTATE_STARTED) failed: %08lx\n", hres);
+
+    hres = IActiveScriptParse_ParseScriptText(parser, script_str, NULL, NULL, NULL, 0, 0, 0, NULL, NULL);
+    ok(hres == S_OK, "ParseScriptText failed: %08lx\n", hres);
+
+    IActiveScriptParse_Release(parser);
+    return engine;
+}
+
+static void close_engine(IActiveScript *engine)
+{
+    HRESULT hres;
+
+    hres = IActiveScript_Close(engine);
+    ok(hres == S_OK, "Close failed: %08lx\n", hres);
+    IActiveScript_Release(engine);
+}
+
+static void test_code_cache(void)
+{
+    static const WCHAR script_str[] =
+        L"var y = 1; function g() { return y++; } var r = g(); ok(r === 1, 'r = ' + r); ok(y === 2, 'y = ' + y);";
+    IActiveScript *anchor, *engine, *engine2;
+
+    /* Keeps the script state of the thread alive, so the engines below can share compiled code. */
+    anchor = parse_script_in_new_engine(L"var z = 0;");
+    if(!anchor)
+        return;
+
+    /* Each engine has to run the shared code with its own globals. */
+    engine = parse_script_in_new_engine(script_str);
+    ok(engine != NULL, "engine == NULL\n");
+    close_engine(engine);
+
+    engine = parse_script_in_new_engine(script_str);
+    ok(engine != NULL, "engine == NULL\n");
+
+    /* The compiled code is still used by engine, so engine2 compiles it again. */
+    engine2 = parse_script_in_new_engine(script_str);
+    ok(engine2 != NULL, "engine2 == NULL\n");
+    close_engine(engine2);
+    close_engine(engine);
+
+    engine = parse_script_in_new_engine(script_str);
+    ok(engine != NULL, "engine == NULL\n");
+    close_engine(engine);
+
+    close_engine(anchor);
+}
+
 static HRESULT invoke_procedure(const WCHAR *args, const WCHAR *source, DISPPARAMS *dp)
 {
     IActiveScriptParseProcedure2 *parse_proc;
@@ -3848,6 +3921,33 @@ static void test_destructors(void)
 
     IActiveScript_Release(script2);
     IActiveScript_Release(script);
+
+    /* Allocating enough live objects collects the cycle without an explicit CollectGarbage() */
+    V_VT(&v) = VT_EMPTY;
+    hres = parse_script_expr(cyclic_refs, &v, &script);
+    ok(hres == S_OK, "parse_script_expr failed: %08lx\n", hres);
+    ok(V_VT(&v) == VT_BOOL, "V_VT(v) = %d\n", V_VT(&v));
+
+    hres = IActiveScript_QueryInterface(script, &IID_IActiveScriptParse, (void**)&parser);
+    ok(hres == S_OK, "Could not get IActiveScriptParse: %08lx\n", hres);
+
+    V_VT(&v) = VT_EMPTY;
+    hres = IActiveScriptParse_ParseScriptText(parser, L"Math.ref = undefined, true",
+                                              NULL, NULL, NULL, 0, 0, SCRIPTTEXT_ISEXPRESSION, &v, NULL);
+    ok(hres == S_OK, "ParseScriptText failed: %08lx\n", hres);
+    ok(V_VT(&v) == VT_BOOL, "V_VT(v) = %d\n", V_VT(&v));
+
+    SET_EXPECT(testdestrobj);
+    V_VT(&v) = VT_EMPTY;
+    hres = IActiveScriptParse_ParseScriptText(parser,
+            L"(function() { var i, a = []; for(i = 0; i < 20000; i++) a.push({}); return true; })()",
+            NULL, NULL, NULL, 0, 0, SCRIPTTEXT_ISEXPRESSION, &v, NULL);
+    ok(hres == S_OK, "ParseScriptText failed: %08lx\n", hres);
+    ok(V_VT(&v) == VT_BOOL, "V_VT(v) = %d\n", V_VT(&v));
+    IActiveScriptParse_Release(parser);
+    CHECK_CALLED(testdestrobj);
+
+    IActiveScript_Release(script);
 }
 
 static void test_eval(void)
@@ -4050,6 +4150,17 @@ static BOOL run_tests(void)
     CHECK_CALLED(global_success_d);
     CHECK_CALLED(global_success_i);
 
+    /* The same source in a new engine may reuse compiled code, but it still has to run. */
+    SET_EXPECT(global_success_d);
+    SET_EXPECT(global_success_i);
+    run_script(L"reportSuccess();");
+    CHECK_CALLED(global_success_d);
+    CHECK_CALLED(global_success_i);
+
+    run_script(L"var x = 1; function f() { return x++; } var r = f(); ok(r === 1, 'r = ' + r); ok(x === 2, 'x = ' + x);");
+    run_script(L"var x = 1; function f() { return x++; } var r = f(); ok(r === 1, 'r = ' + r); ok(x === 2, 'x = ' + x);");
+    test_code_cache();
+
     SET_EXPECT(testobj_delete_test);
     run_script(L"ok((delete testObj.deleteTest) === true, 'delete testObj.deleteTest did not return true');");
     CHECK_CALLED(testobj_delete_test);
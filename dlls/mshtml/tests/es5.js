@@ -395,6 +395,24 @@ sync_test("array_splice", function() {
     var tmp = arr.splice(2);
     ok(arr.toString() === "1,2", "arr = " + arr);
     ok(tmp.toString() === "3,4,5", "tmp = " + tmp);
+
+    var set_calls = 0;
+    Object.defineProperty(Array.prototype, "3", {
+        get: function() { return "getter"; },
+        set: function(v) { set_calls++; },
+        configurable: true
+    });
+    arr = [1,2,3];
+    arr.unshift(0);
+    ok(set_calls === 1, "set_calls = " + set_calls);
+    ok(!arr.hasOwnProperty("3"), "arr[3] is an own property");
+    ok(arr.length === 4, "arr.length = " + arr.length);
+    ok(arr[3] === "getter", "arr[3] = " + arr[3]);
+    arr = [1,2,3];
+    arr.splice(0, 0, "a");
+    ok(set_calls === 2, "set_calls = " + set_calls);
+    ok(!arr.hasOwnProperty("3"), "arr[3] is an own property");
+    delete Array.prototype[3];
 });
 
 sync_test("array_map", function() {
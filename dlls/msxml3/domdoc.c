@@ -75,6 +75,7 @@ typedef struct {
     struct list selectNsList;
     xmlChar const* selectNsStr;
     LONG selectNsStr_len;
+    LONG selectNsId; /* identifies namespace set for compiled query cache, 0 if empty */
     BOOL XPath;
     IUri *uri;
 } domdoc_properties;
@@ -232,6 +233,11 @@ void set_xpathmode(xmlDocPtr doc, BOOL xpath)
     properties_from_xmlDocPtr(doc)->XPath = xpath;
 }
 
+LONG xmldoc_selection_ns_id(xmlDocPtr doc)
+{
+    return properties_from_xmlDocPtr(doc)->selectNsId;
+}
+
 int registerNamespaces(xmlXPathContextPtr ctxt)
 {
     int n = 0;
@@ -285,6 +291,7 @@ static domdoc_properties *create_properties(MSXML_VERSION version)
     properties->schemaCache = NULL;
     properties->selectNsStr = calloc(1, sizeof(xmlChar));
     properties->selectNsStr_len = 0;
+    properties->selectNsId = 0;
 
     /* properties that are dependent on object versions */
     properties->version = version;
@@ -315,6 +322,7 @@ static domdoc_properties* copy_properties(domdoc_properties const* properties)
             IXMLDOMSchemaCollection2_AddRef(pcopy->schemaCache);
         pcopy->XPath = properties->XPath;
         pcopy->selectNsStr_len = properties->selectNsStr_len;
+        pcopy->selectNsId = properties->selectNsId;
         list_init( &pcopy->selectNsList );
         pcopy->selectNsStr = malloc(len);
         memcpy((xmlChar*)pcopy->selectNsStr, properties->selectNsStr, len);
@@ -3083,12 +3091,15 @@ static HRESULT WINAPI domdoc_setProperty(
 
         This->properties->selectNsStr = nsStr;
         This->properties->selectNsStr_len = xmlStrlen(nsStr);
+        This->properties->selectNsId = 0;
         if (bstr && *bstr)
         {
+            static LONG last_ns_id;
             xmlChar *pTokBegin, *pTokEnd, *pTokInner;
             select_ns_entry* ns_entry = NULL;
             xmlXPathContextPtr ctx;
 
+            This->properties->selectNsId = InterlockedIncrement(&last_ns_id);
             ctx = xmlXPathNewContext(This->node.node->doc);
             pTokBegin = nsStr;
 
@@ -389,6 +389,7 @@ BOOL WINAPI DllMain(HINSTANCE hInstDLL, DWORD fdwReason, LPVOID reserved)
         xmlCleanupInputCallbacks();
         xmlRegisterDefaultInputCallbacks();
 
+        selection_cache_cleanup();
         xmlCleanupParser();
         schemasCleanup();
         release_typelib();
@@ -139,6 +139,7 @@ extern IUnknown         *create_doc_fragment( xmlNodePtr );
 extern IUnknown         *create_doc_entity_ref( xmlNodePtr );
 extern IUnknown         *create_doc_type( xmlNodePtr );
 extern HRESULT           create_selection( xmlNodePtr, xmlChar*, IXMLDOMNodeList** );
+extern void              selection_cache_cleanup(void);
 extern HRESULT           create_enumvariant( IUnknown*, BOOL, const struct enumvariant_funcs*, IEnumVARIANT**);
 extern HRESULT           create_dom_implementation(IXMLDOMImplementation **obj);
 
@@ -161,6 +162,7 @@ extern HRESULT xmldoc_remove_orphan( xmlDocPtr doc, xmlNodePtr node );
 extern void xmldoc_link_xmldecl(xmlDocPtr doc, xmlNodePtr node);
 extern xmlNodePtr xmldoc_unlink_xmldecl(xmlDocPtr doc);
 extern MSXML_VERSION xmldoc_version( xmlDocPtr doc );
+extern LONG xmldoc_selection_ns_id( xmlDocPtr doc );
 
 extern HRESULT XMLElement_create( xmlNodePtr node, LPVOID *ppObj, BOOL own );
 
@@ -158,6 +158,27 @@ typedef struct
     BSTR uri;
 } ns;
 
+/* Element and attribute names are interned once per parse, so repeated names
+   share a single BSTR instead of being converted again on every event. */
+struct saxname
+{
+    struct saxname *next;
+    unsigned int hash;
+    BSTR name;
+    /* qualified names are keyed by their interned parts, plain names by their UTF-8 form */
+    BSTR prefix;
+    BSTR local;
+    int len;
+    xmlChar utf8[1];
+};
+
+struct saxname_table
+{
+    struct saxname **buckets;
+    unsigned int size;
+    unsigned int count;
+};
+
 typedef struct
 {
     struct list entry;
@@ -315,7 +336,15 @@ typedef struct
         BSTR szURI;
         BSTR szValue;
         BSTR szQName;
+        /* unconverted value, points to attr_values */
+        const xmlChar *value_start;
+        const xmlChar *value_end;
     } *attributes;
+    xmlChar *attr_values;
+    int attr_values_size;
+    struct saxname_table names;
+    WCHAR *chars;
+    int chars_size;
 } saxlocator;
 
 static inline saxreader *impl_from_IVBSAXXMLReader( IVBSAXXMLReader *iface )
@@ -442,26 +471,174 @@ static BOOL is_namespaces_enabled(const saxreader *reader)
     return (reader->version < MSXML4) || (reader->features & Namespaces);
 }
 
-static BSTR build_qname(BSTR prefix, BSTR local)
+static unsigned int saxname_hash(const void *data, int len)
+{
+    const unsigned char *ptr = data;
+    unsigned int hash = 2166136261u;
+    int i;
+
+    for (i = 0; i < len; i++)
+        hash = (hash ^ ptr[i]) * 16777619u;
+
+    return hash;
+}
+
+static BOOL saxname_table_grow(struct saxname_table *table)
 {
-    if (prefix && *prefix)
+    unsigned int size = table->size ? table->size * 2 : 64, i;
+    struct saxname **buckets, *name, *next;
+
+    if (!(buckets = calloc(size, sizeof(*buckets))))
+        return FALSE;
+
+    for (i = 0; i < table->size; i++)
     {
-        BSTR qname = SysAllocStringLen(NULL, SysStringLen(prefix) + SysStringLen(local) + 1);
-        WCHAR *ptr;
+        for (name = table->buckets[i]; name; name = next)
+        {
+            next = name->next;
+            name->next = buckets[name->hash & (size - 1)];
+            buckets[name->hash & (size - 1)] = name;
+        }
+    }
 
-        ptr = qname;
-        lstrcpyW(ptr, prefix);
-        ptr += SysStringLen(prefix);
-        *ptr++ = ':';
-        lstrcpyW(ptr, local);
-        return qname;
+    free(table->buckets);
+    table->buckets = buckets;
+    table->size = size;
+    return TRUE;
+}
+
+static void saxname_table_insert(struct saxname_table *table, struct saxname *name)
+{
+    struct saxname **bucket = &table->buckets[name->hash & (table->size - 1)];
+
+    name->next = *bucket;
+    *bucket = name;
+    table->count++;
+}
+
+static void saxname_table_free(struct saxname_table *table)
+{
+    struct saxname *name, *next;
+    unsigned int i;
+
+    for (i = 0; i < table->size; i++)
+    {
+        for (name = table->buckets[i]; name; name = next)
+        {
+            next = name->next;
+            SysFreeString(name->name);
+            free(name);
+        }
     }
-    else
-        return SysAllocString(local);
+
+    free(table->buckets);
+    table->buckets = NULL;
+    table->size = table->count = 0;
+}
+
+/* Returned string is owned by the table; NULL is interned as an empty string,
+   same as bstr_from_xmlChar() does. */
+static BSTR saxname_intern(struct saxname_table *table, const xmlChar *str)
+{
+    struct saxname *name;
+    unsigned int hash;
+    int len, lenW;
+
+    if (!str) str = (const xmlChar *)"";
+
+    len = strlen((const char *)str);
+    hash = saxname_hash(str, len);
+
+    if (table->size)
+    {
+        for (name = table->buckets[hash & (table->size - 1)]; name; name = name->next)
+        {
+            if (name->hash == hash && !name->local && name->len == len && !memcmp(name->utf8, str, len))
+                return name->name;
+        }
+    }
+
+    if (table->count >= table->size && !saxname_table_grow(table))
+        return NULL;
+
+    if (!(name = malloc(FIELD_OFFSET(struct saxname, utf8[len + 1]))))
+        return NULL;
+
+    lenW = MultiByteToWideChar(CP_UTF8, 0, (const char *)str, len, NULL, 0);
+    if (!(name->name = SysAllocStringLen(NULL, lenW)))
+    {
+        free(name);
+        return NULL;
+    }
+    MultiByteToWideChar(CP_UTF8, 0, (const char *)str, len, name->name, lenW);
+
+    name->hash = hash;
+    name->prefix = name->local = NULL;
+    name->len = len;
+    memcpy(name->utf8, str, len + 1);
+    saxname_table_insert(table, name);
+
+    return name->name;
+}
+
+/* VB handlers get names by reference and may replace them, so they are given copies
+   instead of the table strings. */
+static BSTR saxname_copy(BSTR name)
+{
+    return name ? SysAllocStringLen(name, SysStringLen(name)) : NULL;
 }
 
-static element_entry* alloc_element_entry(const xmlChar *local, const xmlChar *prefix, int nb_ns,
-    const xmlChar **namespaces)
+/* builds "prefix:local" from interned parts */
+static BSTR saxname_intern_qname(struct saxname_table *table, BSTR prefix, BSTR local)
+{
+    const void *key[2] = { prefix, local };
+    struct saxname *name;
+    unsigned int hash;
+    int prefix_len, local_len;
+
+    if (!local) return NULL;
+    if (!prefix || !*prefix) return local;
+
+    hash = saxname_hash(key, sizeof(key));
+
+    if (table->size)
+    {
+        for (name = table->buckets[hash & (table->size - 1)]; name; name = name->next)
+        {
+            if (name->hash == hash && name->prefix == prefix && name->local == local)
+                return name->name;
+        }
+    }
+
+    if (table->count >= table->size && !saxname_table_grow(table))
+        return NULL;
+
+    if (!(name = malloc(sizeof(*name))))
+        return NULL;
+
+    prefix_len = SysStringLen(prefix);
+    local_len = SysStringLen(local);
+    if (!(name->name = SysAllocStringLen(NULL, prefix_len + local_len + 1)))
+    {
+        free(name);
+        return NULL;
+    }
+    memcpy(name->name, prefix, prefix_len * sizeof(WCHAR));
+    name->name[prefix_len] = ':';
+    memcpy(name->name + prefix_len + 1, local, local_len * sizeof(WCHAR));
+
+    name->hash = hash;
+    name->prefix = prefix;
+    name->local = local;
+    name->len = 0;
+    saxname_table_insert(table, name);
+
+    return name->name;
+}
+
+/* names are borrowed from locator name table */
+static element_entry* alloc_element_entry(saxlocator *locator, const xmlChar *local, const xmlChar *prefix,
+    int nb_ns, const xmlChar **namespaces)
 {
     element_entry *ret;
     int i;
@@ -469,16 +646,16 @@ static element_entry* alloc_element_entry(const xmlChar *local, const xmlChar *p
     ret = malloc(sizeof(*ret));
     if (!ret) return ret;
 
-    ret->local  = bstr_from_xmlChar(local);
-    ret->prefix = bstr_from_xmlChar(prefix);
-    ret->qname  = build_qname(ret->prefix, ret->local);
+    ret->local  = saxname_intern(&locator->names, local);
+    ret->prefix = saxname_intern(&locator->names, prefix);
+    ret->qname  = saxname_intern_qname(&locator->names, ret->prefix, ret->local);
     ret->ns = nb_ns ? malloc(nb_ns * sizeof(ns)) : NULL;
-    ret->ns_count = nb_ns;
+    ret->ns_count = ret->ns ? nb_ns : 0;
 
-    for (i=0; i < nb_ns; i++)
+    for (i=0; i < ret->ns_count; i++)
     {
-        ret->ns[i].prefix = bstr_from_xmlChar(namespaces[2*i]);
-        ret->ns[i].uri = bstr_from_xmlChar(namespaces[2*i+1]);
+        ret->ns[i].prefix = saxname_intern(&locator->names, namespaces[2*i]);
+        ret->ns[i].uri = saxname_intern(&locator->names, namespaces[2*i+1]);
     }
 
     return ret;
@@ -486,18 +663,6 @@ static element_entry* alloc_element_entry(const xmlChar *local, const xmlChar *p
 
 static void free_element_entry(element_entry *element)
 {
-    int i;
-
-    for (i=0; i<element->ns_count;i++)
-    {
-        SysFreeString(element->ns[i].prefix);
-        SysFreeString(element->ns[i].uri);
-    }
-
-    SysFreeString(element->prefix);
-    SysFreeString(element->local);
-    SysFreeString(element->qname);
-
     free(element->ns);
     free(element);
 }
@@ -525,19 +690,16 @@ static BSTR find_element_uri(saxlocator *locator, const xmlChar *uri)
 
     if (!uri) return NULL;
 
-    uriW = bstr_from_xmlChar(uri);
+    /* namespace uris are interned too, so matching one is a pointer compare */
+    if (!(uriW = saxname_intern(&locator->names, uri))) return NULL;
 
     LIST_FOR_EACH_ENTRY(element, &locator->elements, element_entry, entry)
     {
         for (i=0; i < element->ns_count; i++)
-            if (!wcscmp(uriW, element->ns[i].uri))
-            {
-                SysFreeString(uriW);
-                return element->ns[i].uri;
-            }
+            if (uriW == element->ns[i].uri)
+                return uriW;
     }
 
-    SysFreeString(uriW);
     ERR("namespace uri not found, %s\n", debugstr_a((char*)uri));
     return NULL;
 }
@@ -621,19 +783,45 @@ static BSTR bstr_from_xmlCharN(const xmlChar *buf, int len)
     return bstr;
 }
 
-static BSTR QName_from_xmlChar(const xmlChar *prefix, const xmlChar *name)
+/* Libxml2 escapes '&' back to char reference '&#38;' in attribute value,
+   so when document has escaped value with '&amp;' it's parsed to '&' and then
+   escaped to '&#38;'. This function takes care of ampersands only. */
+static BSTR saxreader_get_unescaped_value(const xmlChar *buf, int len)
 {
-    xmlChar *qname;
+    static const WCHAR ampescW[] = {'&','#','3','8',';',0};
+    WCHAR *dest, *ptrW, *str;
+    DWORD str_len;
     BSTR bstr;
 
-    if(!name) return NULL;
+    if (!buf)
+        return NULL;
+
+    str_len = MultiByteToWideChar(CP_UTF8, 0, (LPCSTR)buf, len, NULL, 0);
+    if (len != -1) str_len++;
+
+    str = malloc(str_len * sizeof(WCHAR));
+    if (!str) return NULL;
+
+    MultiByteToWideChar(CP_UTF8, 0, (LPCSTR)buf, len, str, str_len);
+    if (len != -1) str[str_len-1] = 0;
+
+    ptrW = str;
+    while ((dest = wcsstr(ptrW, ampescW)))
+    {
+        WCHAR *src;
+
+        /* leave first '&' from a reference as a value */
+        src = dest + ARRAY_SIZE(ampescW) - 1;
+        dest++;
+
+        /* move together with null terminator */
+        memmove(dest, src, (lstrlenW(src) + 1)*sizeof(WCHAR));
 
-    if(!prefix || !*prefix)
-        return bstr_from_xmlChar(name);
+        ptrW++;
+    }
 
-    qname = xmlBuildQName(name, prefix, NULL, 0);
-    bstr = bstr_from_xmlChar(qname);
-    xmlFree(qname);
+    bstr = SysAllocString(str);
+    free(str);
 
     return bstr;
 }
@@ -664,6 +852,37 @@ static BSTR pooled_bstr_from_xmlCharN(struct bstrpool *pool, const xmlChar *buf,
     return pool_entry;
 }
 
+/* Character data goes through a reusable buffer, VB handlers get a BSTR by reference
+   so they still use pooled strings. */
+static HRESULT saxreader_saxcharacters_xmlchar(saxlocator *locator, const xmlChar *chars, int len)
+{
+    struct saxcontenthandler_iface *content = saxreader_get_contenthandler(locator->saxreader);
+    int lenW;
+
+    if (!saxreader_has_handler(locator, SAXContentHandler)) return S_OK;
+
+    if (locator->vbInterface)
+        return saxreader_saxcharacters(locator, pooled_bstr_from_xmlCharN(&locator->saxreader->pool, chars, len));
+
+    /* UTF-8 input never needs more UTF-16 code units than it has bytes */
+    if (len >= locator->chars_size)
+    {
+        int size = max(len + 1, locator->chars_size * 2);
+        WCHAR *buf;
+
+        if (!(buf = realloc(locator->chars, size * sizeof(WCHAR))))
+            return E_OUTOFMEMORY;
+
+        locator->chars = buf;
+        locator->chars_size = size;
+    }
+
+    lenW = MultiByteToWideChar(CP_UTF8, 0, (const char *)chars, len, locator->chars, len);
+    locator->chars[lenW] = 0;
+
+    return ISAXContentHandler_characters(content->handler, locator->chars, lenW);
+}
+
 static void format_error_message_from_id(saxlocator *This, HRESULT hr)
 {
     struct saxerrorhandler_iface *handler = saxreader_get_errorhandler(This->saxreader);
@@ -1118,6 +1337,20 @@ static inline BOOL is_valid_attr_index(const saxlocator *locator, int index)
     return index < locator->attr_count && index >= 0;
 }
 
+/* values are converted on first access */
+static BSTR get_attribute_value(saxlocator *locator, int index)
+{
+    struct _attributes *attr = &locator->attributes[index];
+
+    if (attr->value_start)
+    {
+        attr->szValue = saxreader_get_unescaped_value(attr->value_start, attr->value_end - attr->value_start);
+        attr->value_start = attr->value_end = NULL;
+    }
+
+    return attr->szValue;
+}
+
 static HRESULT WINAPI isaxattributes_getURI(
         ISAXAttributes* iface,
         int index,
@@ -1315,8 +1548,8 @@ static HRESULT WINAPI isaxattributes_getValue(
     if(!is_valid_attr_index(This, index)) return E_INVALIDARG;
     if(!value || !nValue) return E_POINTER;
 
+    *value = get_attribute_value(This, index);
     *nValue = SysStringLen(This->attributes[index].szValue);
-    *value = This->attributes[index].szValue;
 
     TRACE("(%s:%d)\n", debugstr_w(*value), *nValue);
 
@@ -1383,63 +1616,15 @@ static const struct ISAXAttributesVtbl isaxattributes_vtbl =
     isaxattributes_getValueFromQName
 };
 
-/* Libxml2 escapes '&' back to char reference '&#38;' in attribute value,
-   so when document has escaped value with '&amp;' it's parsed to '&' and then
-   escaped to '&#38;'. This function takes care of ampersands only. */
-static BSTR saxreader_get_unescaped_value(const xmlChar *buf, int len)
-{
-    static const WCHAR ampescW[] = {'&','#','3','8',';',0};
-    WCHAR *dest, *ptrW, *str;
-    DWORD str_len;
-    BSTR bstr;
-
-    if (!buf)
-        return NULL;
-
-    str_len = MultiByteToWideChar(CP_UTF8, 0, (LPCSTR)buf, len, NULL, 0);
-    if (len != -1) str_len++;
-
-    str = malloc(str_len * sizeof(WCHAR));
-    if (!str) return NULL;
-
-    MultiByteToWideChar(CP_UTF8, 0, (LPCSTR)buf, len, str, str_len);
-    if (len != -1) str[str_len-1] = 0;
-
-    ptrW = str;
-    while ((dest = wcsstr(ptrW, ampescW)))
-    {
-        WCHAR *src;
-
-        /* leave first '&' from a reference as a value */
-        src = dest + ARRAY_SIZE(ampescW) - 1;
-        dest++;
-
-        /* move together with null terminator */
-        memmove(dest, src, (lstrlenW(src) + 1)*sizeof(WCHAR));
-
-        ptrW++;
-    }
-
-    bstr = SysAllocString(str);
-    free(str);
-
-    return bstr;
-}
-
 static void free_attribute_values(saxlocator *locator)
 {
     int i;
 
     for (i = 0; i < locator->attr_count; i++)
     {
-        SysFreeString(locator->attributes[i].szLocalname);
-        locator->attributes[i].szLocalname = NULL;
-
         SysFreeString(locator->attributes[i].szValue);
         locator->attributes[i].szValue = NULL;
-
-        SysFreeString(locator->attributes[i].szQName);
-        locator->attributes[i].szQName = NULL;
+        locator->attributes[i].value_start = locator->attributes[i].value_end = NULL;
     }
 }
 
@@ -1448,10 +1633,10 @@ static HRESULT SAXAttributes_populate(saxlocator *locator,
         int nb_attributes, const xmlChar **xmlAttributes)
 {
     static const xmlChar xmlns[] = "xmlns";
-    static const WCHAR xmlnsW[] = { 'x','m','l','n','s',0 };
 
     struct _attributes *attrs;
-    int i;
+    xmlChar *values;
+    int i, size;
 
     /* skip namespace definitions */
     if ((locator->saxreader->features & NamespacePrefixes) == 0)
@@ -1478,21 +1663,40 @@ static HRESULT SAXAttributes_populate(saxlocator *locator,
         attrs = locator->attributes;
     }
 
+    /* libxml2 buffers don't outlive the callback, so raw values are copied and
+       stay valid until the element ends, same as converted ones */
+    for (i = 0, size = 0; i < nb_attributes; i++)
+        size += xmlAttributes[i*5+4] - xmlAttributes[i*5+3];
+    if (size >= locator->attr_values_size)
+    {
+        int new_size = max(size + 1, locator->attr_values_size * 2);
+
+        if (!(values = realloc(locator->attr_values, new_size)))
+        {
+            free_attribute_values(locator);
+            locator->attr_count = 0;
+            return E_OUTOFMEMORY;
+        }
+        locator->attr_values = values;
+        locator->attr_values_size = new_size;
+    }
+    values = locator->attr_values;
+
     for (i = 0; i < nb_namespaces; i++)
     {
-        SysFreeString(attrs[nb_attributes+i].szLocalname);
-        attrs[nb_attributes+i].szLocalname = SysAllocStringLen(NULL, 0);
+        attrs[nb_attributes+i].szLocalname = saxname_intern(&locator->names, NULL);
 
         attrs[nb_attributes+i].szURI = locator->namespaceUri;
 
         SysFreeString(attrs[nb_attributes+i].szValue);
         attrs[nb_attributes+i].szValue = bstr_from_xmlChar(xmlNamespaces[2*i+1]);
+        attrs[nb_attributes+i].value_start = attrs[nb_attributes+i].value_end = NULL;
 
-        SysFreeString(attrs[nb_attributes+i].szQName);
         if(!xmlNamespaces[2*i])
-            attrs[nb_attributes+i].szQName = SysAllocString(xmlnsW);
+            attrs[nb_attributes+i].szQName = saxname_intern(&locator->names, xmlns);
         else
-            attrs[nb_attributes+i].szQName = QName_from_xmlChar(xmlns, xmlNamespaces[2*i]);
+            attrs[nb_attributes+i].szQName = saxname_intern_qname(&locator->names,
+                    saxname_intern(&locator->names, xmlns), saxname_intern(&locator->names, xmlNamespaces[2*i]));
     }
 
     for (i = 0; i < nb_attributes; i++)
@@ -1500,19 +1704,23 @@ static HRESULT SAXAttributes_populate(saxlocator *locator,
         static const xmlChar xmlA[] = "xml";
 
         if (xmlStrEqual(xmlAttributes[i*5+1], xmlA))
-            attrs[i].szURI = bstr_from_xmlChar(xmlAttributes[i*5+2]);
+            attrs[i].szURI = saxname_intern(&locator->names, xmlAttributes[i*5+2]);
         else
             /* that's an important feature to keep same uri pointer for every reported attribute */
             attrs[i].szURI = find_element_uri(locator, xmlAttributes[i*5+2]);
 
-        SysFreeString(attrs[i].szLocalname);
-        attrs[i].szLocalname = bstr_from_xmlChar(xmlAttributes[i*5]);
+        attrs[i].szLocalname = saxname_intern(&locator->names, xmlAttributes[i*5]);
 
         SysFreeString(attrs[i].szValue);
-        attrs[i].szValue = saxreader_get_unescaped_value(xmlAttributes[i*5+3], xmlAttributes[i*5+4]-xmlAttributes[i*5+3]);
+        attrs[i].szValue = NULL;
+        size = xmlAttributes[i*5+4] - xmlAttributes[i*5+3];
+        memcpy(values, xmlAttributes[i*5+3], size);
+        attrs[i].value_start = values;
+        attrs[i].value_end = values + size;
+        values += size;
 
-        SysFreeString(attrs[i].szQName);
-        attrs[i].szQName = QName_from_xmlChar(xmlAttributes[i*5+1], xmlAttributes[i*5]);
+        attrs[i].szQName = saxname_intern_qname(&locator->names,
+                saxname_intern(&locator->names, xmlAttributes[i*5+1]), attrs[i].szLocalname);
     }
 
     return S_OK;
@@ -1612,7 +1820,7 @@ static void libxmlStartElementNS(
     if(This->saxreader->version < MSXML4)
         This->column++;
 
-    element = alloc_element_entry(localname, prefix, nb_namespaces, namespaces);
+    element = alloc_element_entry(This, localname, prefix, nb_namespaces, namespaces);
     push_element_ns(This, element);
 
     if (is_namespaces_enabled(This->saxreader))
@@ -1622,10 +1830,14 @@ static void libxmlStartElementNS(
         for (i = 0; i < nb_namespaces && saxreader_has_handler(This, SAXContentHandler); i++)
         {
             if (This->vbInterface)
-                hr = IVBSAXContentHandler_startPrefixMapping(
-                        handler->vbhandler,
-                        &element->ns[i].prefix,
-                        &element->ns[i].uri);
+            {
+                BSTR ns_prefix = saxname_copy(element->ns[i].prefix);
+                BSTR ns_uri = saxname_copy(element->ns[i].uri);
+
+                hr = IVBSAXContentHandler_startPrefixMapping(handler->vbhandler, &ns_prefix, &ns_uri);
+                SysFreeString(ns_prefix);
+                SysFreeString(ns_uri);
+            }
             else
                 hr = ISAXContentHandler_startPrefixMapping(
                         handler->handler,
@@ -1654,8 +1866,16 @@ static void libxmlStartElementNS(
             uri = local = NULL;
 
         if (This->vbInterface)
+        {
+            BSTR uri_copy = saxname_copy(uri), local_copy = saxname_copy(local);
+            BSTR qname_copy = saxname_copy(element->qname);
+
             hr = IVBSAXContentHandler_startElement(handler->vbhandler,
-                    &uri, &local, &element->qname, &This->IVBSAXAttributes_iface);
+                    &uri_copy, &local_copy, &qname_copy, &This->IVBSAXAttributes_iface);
+            SysFreeString(uri_copy);
+            SysFreeString(local_copy);
+            SysFreeString(qname_copy);
+        }
         else
             hr = ISAXContentHandler_startElement(handler->handler,
                     uri ? uri : &empty_str, SysStringLen(uri),
@@ -1726,9 +1946,15 @@ static void libxmlEndElementNS(
         uri = local = NULL;
 
     if (This->vbInterface)
-        hr = IVBSAXContentHandler_endElement(
-                handler->vbhandler,
-                &uri, &local, &element->qname);
+    {
+        BSTR uri_copy = saxname_copy(uri), local_copy = saxname_copy(local);
+        BSTR qname_copy = saxname_copy(element->qname);
+
+        hr = IVBSAXContentHandler_endElement(handler->vbhandler, &uri_copy, &local_copy, &qname_copy);
+        SysFreeString(uri_copy);
+        SysFreeString(local_copy);
+        SysFreeString(qname_copy);
+    }
     else
         hr = ISAXContentHandler_endElement(
                 handler->handler,
@@ -1752,8 +1978,12 @@ static void libxmlEndElementNS(
         while (iterate_endprefix_index(This, element, &i) && saxreader_has_handler(This, SAXContentHandler))
         {
             if (This->vbInterface)
-                hr = IVBSAXContentHandler_endPrefixMapping(
-                        handler->vbhandler, &element->ns[i].prefix);
+            {
+                BSTR ns_prefix = saxname_copy(element->ns[i].prefix);
+
+                hr = IVBSAXContentHandler_endPrefixMapping(handler->vbhandler, &ns_prefix);
+                SysFreeString(ns_prefix);
+            }
             else
                 hr = ISAXContentHandler_endPrefixMapping(
                         handler->handler, element->ns[i].prefix, SysStringLen(element->ns[i].prefix));
@@ -1774,7 +2004,6 @@ static void libxmlCharacters(
         int len)
 {
     saxlocator *This = ctx;
-    BSTR Chars;
     HRESULT hr;
     xmlChar *cur, *end;
     BOOL lastEvent = FALSE;
@@ -1831,8 +2060,7 @@ static void libxmlCharacters(
                 This->column = 0;
         }
 
-        Chars = pooled_bstr_from_xmlCharN(&This->saxreader->pool, cur, end-cur);
-        hr = saxreader_saxcharacters(This, Chars);
+        hr = saxreader_saxcharacters_xmlchar(This, cur, end-cur);
 
         if (sax_callback_failed(This, hr))
         {
@@ -2332,11 +2560,7 @@ static ULONG WINAPI isaxlocator_Release(
         SysFreeString(This->namespaceUri);
 
         for(index = 0; index < This->attr_alloc_count; index++)
-        {
-            SysFreeString(This->attributes[index].szLocalname);
             SysFreeString(This->attributes[index].szValue);
-            SysFreeString(This->attributes[index].szQName);
-        }
         free(This->attributes);
 
         /* element stack */
@@ -2346,6 +2570,10 @@ static ULONG WINAPI isaxlocator_Release(
             free_element_entry(element);
         }
 
+        free(This->attr_values);
+        saxname_table_free(&This->names);
+        free(This->chars);
+
         ISAXXMLReader_Release(&This->saxreader->ISAXXMLReader_iface);
         free(This);
     }
@@ -2479,6 +2707,11 @@ static HRESULT SAXLocator_create(saxreader *reader, saxlocator **ppsaxlocator, B
     }
 
     list_init(&locator->elements);
+    locator->attr_values = NULL;
+    locator->attr_values_size = 0;
+    memset(&locator->names, 0, sizeof(locator->names));
+    locator->chars = NULL;
+    locator->chars_size = 0;
 
     *ppsaxlocator = locator;
 
@@ -77,6 +77,101 @@ typedef struct
     IEnumVARIANT *enumvariant;
 } domselection;
 
+/* Compiled queries are cached by text, selection language and selection namespaces,
+ * since both pattern translation and compilation resolve prefixes. An entry is
+ * taken out of the cache while it's evaluated, so threads never share one.
+ */
+struct query_cache_entry
+{
+    struct list entry;
+    BOOL xpath;
+    LONG ns_id;
+    xmlChar *query;
+    xmlXPathCompExprPtr comp;
+};
+
+#define QUERY_CACHE_SIZE 64
+
+static struct list query_cache = LIST_INIT(query_cache);
+static unsigned int query_cache_count;
+
+static CRITICAL_SECTION query_cache_cs;
+static CRITICAL_SECTION_DEBUG query_cache_cs_dbg =
+{
+    0, 0, &query_cache_cs,
+    { &query_cache_cs_dbg.ProcessLocksList, &query_cache_cs_dbg.ProcessLocksList },
+      0, 0, { (DWORD_PTR)(__FILE__ ": query_cache") }
+};
+static CRITICAL_SECTION query_cache_cs = { &query_cache_cs_dbg, -1, 0, 0, 0, 0 };
+
+static void free_query_cache_entry(struct query_cache_entry *entry)
+{
+    xmlXPathFreeCompExpr(entry->comp);
+    xmlFree(entry->query);
+    free(entry);
+}
+
+static struct query_cache_entry *query_cache_get(BOOL xpath, LONG ns_id, const xmlChar *query)
+{
+    struct query_cache_entry *entry;
+
+    EnterCriticalSection(&query_cache_cs);
+    LIST_FOR_EACH_ENTRY(entry, &query_cache, struct query_cache_entry, entry)
+    {
+        if (entry->xpath == xpath && entry->ns_id == ns_id && xmlStrEqual(entry->query, query))
+        {
+            list_remove(&entry->entry);
+            query_cache_count--;
+            LeaveCriticalSection(&query_cache_cs);
+            return entry;
+        }
+    }
+    LeaveCriticalSection(&query_cache_cs);
+
+    return NULL;
+}
+
+/* puts entry back as most recently used, dropping least recently used ones */
+static void query_cache_put(struct query_cache_entry *entry)
+{
+    struct query_cache_entry *dup, *last = NULL;
+
+    EnterCriticalSection(&query_cache_cs);
+    LIST_FOR_EACH_ENTRY(dup, &query_cache, struct query_cache_entry, entry)
+    {
+        /* same query compiled concurrently by another thread */
+        if (dup->xpath == entry->xpath && dup->ns_id == entry->ns_id && xmlStrEqual(dup->query, entry->query))
+        {
+            LeaveCriticalSection(&query_cache_cs);
+            free_query_cache_entry(entry);
+            return;
+        }
+    }
+
+    list_add_head(&query_cache, &entry->entry);
+    if (++query_cache_count > QUERY_CACHE_SIZE)
+    {
+        last = LIST_ENTRY(list_tail(&query_cache), struct query_cache_entry, entry);
+        list_remove(&last->entry);
+        query_cache_count--;
+    }
+    LeaveCriticalSection(&query_cache_cs);
+
+    if (last) free_query_cache_entry(last);
+}
+
+void selection_cache_cleanup(void)
+{
+    struct query_cache_entry *entry, *entry2;
+
+    LIST_FOR_EACH_ENTRY_SAFE(entry, entry2, &query_cache, struct query_cache_entry, entry)
+    {
+        list_remove(&entry->entry);
+        free_query_cache_entry(entry);
+    }
+    query_cache_count = 0;
+}
+
 static HRESULT selection_get_item(IUnknown *iface, LONG index, VARIANT* item)
 {
     V_VT(item) = VT_DISPATCH;
@@ -765,7 +860,10 @@ HRESULT create_selection(xmlNodePtr node, xmlChar* query, IXMLDOMNodeList **out)
 {
     domselection *This = malloc(sizeof(domselection));
     xmlXPathContextPtr ctxt = xmlXPathNewContext(node->doc);
+    struct query_cache_entry *cached;
     HRESULT hr;
+    BOOL xpath;
+    LONG ns_id;
 
     TRACE("(%p, %s, %p)\n", node, debugstr_a((char const*)query), out);
 
@@ -790,15 +888,13 @@ HRESULT create_selection(xmlNodePtr node, xmlChar* query, IXMLDOMNodeList **out)
     registerNamespaces(ctxt);
     xmlXPathContextSetCache(ctxt, 1, -1, 0);
 
-    if (is_xpathmode(This->node->doc))
+    xpath = is_xpathmode(This->node->doc);
+    if (xpath)
     {
         xmlXPathRegisterAllFunctions(ctxt);
-        This->result = xmlXPathEvalExpression(query, ctxt);
     }
     else
     {
-        xmlChar* pattern_query = XSLPattern_to_XPath(ctxt, query);
-
         xmlXPathRegisterFunc(ctxt, (xmlChar const*)"not", xmlXPathNotFunction);
         xmlXPathRegisterFunc(ctxt, (xmlChar const*)"boolean", xmlXPathBooleanFunction);
 
@@ -812,10 +908,40 @@ HRESULT create_selection(xmlNodePtr node, xmlChar* query, IXMLDOMNodeList **out)
         xmlXPathRegisterFunc(ctxt, (xmlChar const*)"OP_ILEq", XSLPattern_OP_ILEq);
         xmlXPathRegisterFunc(ctxt, (xmlChar const*)"OP_IGt", XSLPattern_OP_IGt);
         xmlXPathRegisterFunc(ctxt, (xmlChar const*)"OP_IGEq", XSLPattern_OP_IGEq);
+    }
 
-        This->result = xmlXPathEvalExpression(pattern_query, ctxt);
-        xmlFree(pattern_query);
+    ns_id = xmldoc_selection_ns_id(This->node->doc);
+    if (!(cached = query_cache_get(xpath, ns_id, query)))
+    {
+        xmlXPathCompExprPtr comp;
+
+        if (xpath)
+            comp = xmlXPathCtxtCompile(ctxt, query);
+        else
+        {
+            xmlChar* pattern_query = XSLPattern_to_XPath(ctxt, query);
+            comp = xmlXPathCtxtCompile(ctxt, pattern_query);
+            xmlFree(pattern_query);
+        }
+
+        if (comp && (cached = malloc(sizeof(*cached))))
+        {
+            cached->xpath = xpath;
+            cached->ns_id = ns_id;
+            cached->query = xmlStrdup(query);
+            cached->comp = comp;
+        }
+        else
+            xmlXPathFreeCompExpr(comp);
+    }
+
+    if (cached)
+    {
+        This->result = xmlXPathCompiledEval(cached->comp, ctxt);
+        query_cache_put(cached);
     }
+    else
+        This->result = NULL;
 
     if (!This->result || This->result->type != XPATH_NODESET)
     {
@@ -2966,6 +2966,240 @@ static void test_saxreader_encoding(void)
     }
 }
 
+static const char attr_values_xml[] =
+    "<root xmlns:p=\"urn:a\">"
+    "<p:item p:attr=\"1\" attr=\"one\">x</p:item>"
+    "<p:item p:attr=\"2\" attr=\"two\">y</p:item>"
+    "<item xmlns:p=\"urn:c\" p:attr=\"3&amp;4\">z</item>"
+    "</root>";
+
+struct attr_values_element
+{
+    const char *qname;
+    const char *uri;
+    int attr_count;
+    struct
+    {
+        const char *qname;
+        const char *uri;
+        const char *value;
+    } attrs[2];
+};
+
+static const struct attr_values_element attr_values_elements[] =
+{
+    { "root", "", 0 },
+    { "p:item", "urn:a", 2, {{ "p:attr", "urn:a", "1" }, { "attr", "", "one" }} },
+    { "p:item", "urn:a", 2, {{ "p:attr", "urn:a", "2" }, { "attr", "", "two" }} },
+    { "item", "", 1, {{ "p:attr", "urn:c", "3&4" }} },
+};
+
+static int attr_values_index;
+static ISAXAttributes *attr_values_attrs;
+
+static BOOL is_str_equal(const WCHAR *str, int len, const char *expected)
+{
+    return len == strlen(expected) && !memcmp(str, _bstr_(expected), len * sizeof(WCHAR));
+}
+
+static void check_attr_values(ISAXAttributes *saxattr, const struct attr_values_element *element)
+{
+    const WCHAR *uri, *qname, *value;
+    int i, len, uri_len, qname_len, value_len;
+    HRESULT hr;
+
+    len = -1;
+    hr = ISAXAttributes_getLength(saxattr, &len);
+    ok(hr == S_OK, "Unexpected hr %#lx.\n", hr);
+    ok(len == element->attr_count, "%s: got %d attributes.\n", element->qname, len);
+
+    for (i = 0; i < len && i < element->attr_count; i++)
+    {
+        hr = ISAXAttributes_getURI(saxattr, i, &uri, &uri_len);
+        ok(hr == S_OK, "Unexpected hr %#lx.\n", hr);
+        ok(is_str_equal(uri, uri_len, element->attrs[i].uri), "%s: got uri %s.\n",
+                element->qname, wine_dbgstr_wn(uri, uri_len));
+
+        hr = ISAXAttributes_getQName(saxattr, i, &qname, &qname_len);
+        ok(hr == S_OK, "Unexpected hr %#lx.\n", hr);
+        ok(is_str_equal(qname, qname_len, element->attrs[i].qname), "%s: got qname %s.\n",
+                element->qname, wine_dbgstr_wn(qname, qname_len));
+
+        hr = ISAXAttributes_getValue(saxattr, i, &value, &value_len);
+        ok(hr == S_OK, "Unexpected hr %#lx.\n", hr);
+        ok(is_str_equal(value, value_len, element->attrs[i].value), "%s: got value %s.\n",
+                element->qname, wine_dbgstr_wn(value, value_len));
+    }
+}
+
+static HRESULT WINAPI attrvaluesHandler_QueryInterface(ISAXContentHandler *iface, REFIID riid, void **obj)
+{
+    if (IsEqualGUID(riid, &IID_IUnknown) || IsEqualGUID(riid, &IID_ISAXContentHandler))
+    {
+        *obj = iface;
+        return S_OK;
+    }
+
+    *obj = NULL;
+    return E_NOINTERFACE;
+}
+
+static ULONG WINAPI attrvaluesHandler_AddRef(ISAXContentHandler *iface)
+{
+    return 2;
+}
+
+static ULONG WINAPI attrvaluesHandler_Release(ISAXContentHandler *iface)
+{
+    return 1;
+}
+
+static HRESULT WINAPI attrvaluesHandler_putDocumentLocator(ISAXContentHandler *iface, ISAXLocator *locator)
+{
+    return S_OK;
+}
+
+static HRESULT WINAPI attrvaluesHandler_startDocument(ISAXContentHandler *iface)
+{
+    return S_OK;
+}
+
+static HRESULT WINAPI attrvaluesHandler_endDocument(ISAXContentHandler *iface)
+{
+    return S_OK;
+}
+
+static HRESULT WINAPI attrvaluesHandler_startPrefixMapping(ISAXContentHandler *iface,
+        const WCHAR *prefix, int prefix_len, const WCHAR *uri, int uri_len)
+{
+    return S_OK;
+}
+
+static HRESULT WINAPI attrvaluesHandler_endPrefixMapping(ISAXContentHandler *iface,
+        const WCHAR *prefix, int len)
+{
+    return S_OK;
+}
+
+static HRESULT WINAPI attrvaluesHandler_startElement(ISAXContentHandler *iface,
+        const WCHAR *uri, int uri_len, const WCHAR *localname, int local_len,
+        const WCHAR *qname, int qname_len, ISAXAttributes *saxattr)
+{
+    const struct attr_values_element *element;
+
+    ok(attr_values_index < ARRAY_SIZE(attr_values_elements), "Unexpected element %s.\n",
+            wine_dbgstr_wn(qname, qname_len));
+    if (attr_values_index >= ARRAY_SIZE(attr_values_elements))
+        return S_OK;
+    element = &attr_values_elements[attr_values_index++];
+
+    ok(is_str_equal(qname, qname_len, element->qname), "Unexpected qname %s.\n",
+            wine_dbgstr_wn(qname, qname_len));
+    ok(is_str_equal(uri, uri_len, element->uri), "%s: got uri %s.\n", element->qname,
+            wine_dbgstr_wn(uri, uri_len));
+
+    check_attr_values(saxattr, element);
+    attr_values_attrs = saxattr;
+    return S_OK;
+}
+
+static HRESULT WINAPI attrvaluesHandler_endElement(ISAXContentHandler *iface,
+        const WCHAR *uri, int uri_len, const WCHAR *localname, int local_len,
+        const WCHAR *qname, int qname_len)
+{
+    attr_values_attrs = NULL;
+    return S_OK;
+}
+
+static HRESULT WINAPI attrvaluesHandler_characters(ISAXContentHandler *iface, const WCHAR *chars, int len)
+{
+    /* values are still available after startElement returned */
+    ok(attr_values_attrs != NULL, "Unexpected characters %s.\n", wine_dbgstr_wn(chars, len));
+    if (attr_values_attrs)
+        check_attr_values(attr_values_attrs, &attr_values_elements[attr_values_index - 1]);
+    return S_OK;
+}
+
+static HRESULT WINAPI attrvaluesHandler_ignorableWhitespace(ISAXContentHandler *iface,
+        const WCHAR *chars, int len)
+{
+    return S_OK;
+}
+
+static HRESULT WINAPI attrvaluesHandler_processingInstruction(ISAXContentHandler *iface,
+        const WCHAR *target, int target_len, const WCHAR *data, int data_len)
+{
+    return S_OK;
+}
+
+static HRESULT WINAPI attrvaluesHandler_skippedEntity(ISAXContentHandler *iface, const WCHAR *name, int len)
+{
+    return S_OK;
+}
+
+static const ISAXContentHandlerVtbl attrvaluesHandlerVtbl =
+{
+    attrvaluesHandler_QueryInterface,
+    attrvaluesHandler_AddRef,
+    attrvaluesHandler_Release,
+    attrvaluesHandler_putDocumentLocator,
+    attrvaluesHandler_startDocument,
+    attrvaluesHandler_endDocument,
+    attrvaluesHandler_startPrefixMapping,
+    attrvaluesHandler_endPrefixMapping,
+    attrvaluesHandler_startElement,
+    attrvaluesHandler_endElement,
+    attrvaluesHandler_characters,
+    attrvaluesHandler_ignorableWhitespace,
+    attrvaluesHandler_processingInstruction,
+    attrvaluesHandler_skippedEntity
+};
+
+static ISAXContentHandler attrvaluesHandler = { &attrvaluesHandlerVtbl };
+
+static void test_saxreader_attribute_values(void)
+{
+    const struct msxmlsupported_data_t *table = reader_support_data;
+
+    while (table->clsid)
+    {
+        ISAXXMLReader *reader;
+        VARIANT input;
+        HRESULT hr;
+
+        if (!is_clsid_supported(table->clsid, reader_support_data))
+        {
+            table++;
+            continue;
+        }
+
+        hr = CoCreateInstance(table->clsid, NULL, CLSCTX_INPROC_SERVER, &IID_ISAXXMLReader, (void**)&reader);
+        ok(hr == S_OK, "Unexpected hr %#lx.\n", hr);
+
+        hr = ISAXXMLReader_putContentHandler(reader, &attrvaluesHandler);
+        ok(hr == S_OK, "Unexpected hr %#lx.\n", hr);
+
+        /* parse twice, so the second pass sees names from the first one again */
+        attr_values_index = 0;
+        V_VT(&input) = VT_BSTR;
+        V_BSTR(&input) = _bstr_(attr_values_xml);
+        hr = ISAXXMLReader_parse(reader, input);
+        ok(hr == S_OK, "%s: unexpected hr %#lx.\n", table->name, hr);
+        ok(attr_values_index == ARRAY_SIZE(attr_values_elements), "%s: got %d elements.\n",
+                table->name, attr_values_index);
+
+        attr_values_index = 0;
+        hr = ISAXXMLReader_parse(reader, input);
+        ok(hr == S_OK, "%s: unexpected hr %#lx.\n", table->name, hr);
+        ok(attr_values_index == ARRAY_SIZE(attr_values_elements), "%s: got %d elements.\n",
+                table->name, attr_values_index);
+
+        ISAXXMLReader_Release(reader);
+        free_bstrs();
+        table++;
+    }
+}
+
 static void test_mxwriter_handlers(void)
 {
     IMXWriter *writer;
@@ -6034,6 +6268,7 @@ START_TEST(saxreader)
     test_saxreader_properties();
     test_saxreader_features();
     test_saxreader_encoding();
+    test_saxreader_attribute_values();
     test_saxreader_dispex();
 
     /* MXXMLWriter tests */
@@ -165,6 +165,7 @@ static unsigned push_instr(compile_ctx_t *ctx, vbsop_t op)
 
     ctx->code->instrs[ctx->instr_cnt].op = op;
     ctx->code->instrs[ctx->instr_cnt].loc = ctx->loc;
+    ctx->code->instrs[ctx->instr_cnt].cache = NULL;
     return ctx->instr_cnt++;
 }
 
@@ -1494,6 +1495,95 @@ static HRESULT fill_array_desc(compile_ctx_t *ctx, dim_decl_t *dim_decl, array_d
     return S_OK;
 }
 
+static BOOL bind_local(function_t *func, const WCHAR *name, int *ret)
+{
+    unsigned i;
+
+    if(func->type == FUNC_GLOBAL || !wcsicmp(name, func->name))
+        return FALSE;
+
+    for(i = 0; i < func->var_cnt; i++) {
+        if(!wcsicmp(func->vars[i].name, name)) {
+            *ret = i;
+            return TRUE;
+        }
+    }
+
+    for(i = 0; i < func->arg_cnt; i++) {
+        if(!wcsicmp(func->args[i].name, name)) {
+            *ret = -i - 1;
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+/*
+ * Nothing shadows a function's variables and arguments, so once all of its Dim statements are known,
+ * instructions naming them are bound to their slots. Other named lookups get a binding cache.
+ */
+static HRESULT bind_identifiers(compile_ctx_t *ctx, function_t *func)
+{
+    instr_t *instr, *end = ctx->code->instrs + ctx->instr_cnt;
+    int ref;
+
+    for(instr = ctx->code->instrs + func->code_off; instr < end; instr++) {
+        switch(instr->op) {
+        case OP_ident:
+            instr->arg2.uint = 0;
+            /* fall through */
+        case OP_icall:
+            if(bind_local(func, instr->arg1.bstr, &ref)) {
+                instr->op = OP_local;
+                instr->arg1.lng = ref;
+                continue;
+            }
+            break;
+        case OP_assign_ident:
+            if(bind_local(func, instr->arg1.bstr, &ref)) {
+                instr->op = OP_assign_local;
+                instr->arg1.lng = ref;
+                continue;
+            }
+            break;
+        case OP_set_ident:
+            if(bind_local(func, instr->arg1.bstr, &ref)) {
+                instr->op = OP_set_local;
+                instr->arg1.lng = ref;
+                continue;
+            }
+            break;
+        case OP_incc:
+            if(bind_local(func, instr->arg1.bstr, &ref)) {
+                instr->op = OP_incc_local;
+                instr->arg1.lng = ref;
+            }
+            continue;
+        case OP_step:
+            if(bind_local(func, instr->arg2.bstr, &ref)) {
+                instr->op = OP_step_local;
+                instr->arg2.lng = ref;
+            }
+            continue;
+        case OP_icallv:
+        case OP_mcall:
+        case OP_mcallv:
+        case OP_assign_member:
+        case OP_set_member:
+            break;
+        default:
+            continue;
+        }
+
+        instr->cache = compiler_alloc_zero(ctx->code, sizeof(*instr->cache));
+        if(!instr->cache)
+            return E_OUTOFMEMORY;
+    }
+
+    return S_OK;
+}
+
 static HRESULT compile_func(compile_ctx_t *ctx, statement_t *stat, function_t *func)
 {
     HRESULT hres;
@@ -1582,7 +1672,7 @@ static HRESULT compile_func(compile_ctx_t *ctx, statement_t *stat, function_t *f
         assert(array_id == func->array_cnt);
     }
 
-    return S_OK;
+    return bind_identifiers(ctx, func);
 }
 
 static BOOL lookup_funcs_name(compile_ctx_t *ctx, const WCHAR *name)
@@ -94,7 +94,16 @@ static BOOL lookup_dynamic_vars(dynamic_var_t *var, const WCHAR *name, ref_t *re
     return FALSE;
 }
 
-static BOOL lookup_global_vars(ScriptDisp *script, const WCHAR *name, ref_t *ref)
+static void bind_global(ScriptDisp *script, bind_cache_t *cache, bind_type_t type, DISPID id)
+{
+    if(cache) {
+        cache->type = type;
+        cache->gen = script->bind_gen;
+        cache->id = id;
+    }
+}
+
+static BOOL lookup_global_vars(ScriptDisp *script, const WCHAR *name, bind_cache_t *cache, ref_t *ref)
 {
     dynamic_var_t **vars = script->global_vars;
     size_t i, cnt = script->global_vars_cnt;
@@ -103,6 +112,7 @@ static BOOL lookup_global_vars(ScriptDisp *script, const WCHAR *name, ref_t *ref
         if(!wcsicmp(vars[i]->name, name)) {
             ref->type = vars[i]->is_const ? REF_CONST : REF_VAR;
             ref->u.v = &vars[i]->v;
+            bind_global(script, cache, BIND_GLOBAL_VAR, i);
             return TRUE;
         }
     }
@@ -110,7 +120,7 @@ static BOOL lookup_global_vars(ScriptDisp *script, const WCHAR *name, ref_t *ref
     return FALSE;
 }
 
-static BOOL lookup_global_funcs(ScriptDisp *script, const WCHAR *name, ref_t *ref)
+static BOOL lookup_global_funcs(ScriptDisp *script, const WCHAR *name, bind_cache_t *cache, ref_t *ref)
 {
     function_t **funcs = script->global_funcs;
     size_t i, cnt = script->global_funcs_cnt;
@@ -119,6 +129,7 @@ static BOOL lookup_global_funcs(ScriptDisp *script, const WCHAR *name, ref_t *re
         if(!wcsicmp(funcs[i]->name, name)) {
             ref->type = REF_FUNC;
             ref->u.f = funcs[i];
+            bind_global(script, cache, BIND_GLOBAL_FUNC, i);
             return TRUE;
         }
     }
@@ -126,7 +137,42 @@ static BOOL lookup_global_funcs(ScriptDisp *script, const WCHAR *name, ref_t *re
     return FALSE;
 }
 
-static HRESULT lookup_identifier(exec_ctx_t *ctx, BSTR name, vbdisp_invoke_type_t invoke_type, ref_t *ref)
+static BOOL lookup_bound_global(exec_ctx_t *ctx, const bind_cache_t *cache, ref_t *ref)
+{
+    ScriptDisp *script_obj = ctx->script->script_obj;
+
+    if(!cache || cache->gen != script_obj->bind_gen)
+        return FALSE;
+
+    switch(cache->type) {
+    case BIND_GLOBAL_VAR: {
+        dynamic_var_t *var = script_obj->global_vars[cache->id];
+        ref->type = var->is_const ? REF_CONST : REF_VAR;
+        ref->u.v = &var->v;
+        return TRUE;
+    }
+    case BIND_GLOBAL_FUNC:
+        ref->type = REF_FUNC;
+        ref->u.f = script_obj->global_funcs[cache->id];
+        return TRUE;
+    case BIND_BUILTIN:
+        ref->type = REF_DISP;
+        ref->u.d.disp = &ctx->script->global_obj->IDispatch_iface;
+        ref->u.d.id = cache->id;
+        return TRUE;
+    default:
+        return FALSE;
+    }
+}
+
+/* Variables and arguments bound by the compiler. Arguments are numbered from -1 down. */
+static inline VARIANT *local_slot(exec_ctx_t *ctx, int ref)
+{
+    return ref < 0 ? ctx->args - ref - 1 : ctx->vars + ref;
+}
+
+static HRESULT lookup_identifier(exec_ctx_t *ctx, BSTR name, vbdisp_invoke_type_t invoke_type, bind_cache_t *cache,
+        ref_t *ref)
 {
     ScriptDisp *script_obj = ctx->script->script_obj;
     named_item_t *item;
@@ -183,9 +229,9 @@ static HRESULT lookup_identifier(exec_ctx_t *ctx, BSTR name, vbdisp_invoke_type_
     }
 
     if(ctx->code->named_item) {
-        if(lookup_global_vars(ctx->code->named_item->script_obj, name, ref))
+        if(lookup_global_vars(ctx->code->named_item->script_obj, name, NULL, ref))
             return S_OK;
-        if(lookup_global_funcs(ctx->code->named_item->script_obj, name, ref))
+        if(lookup_global_funcs(ctx->code->named_item->script_obj, name, NULL, ref))
             return S_OK;
     }
 
@@ -201,9 +247,13 @@ static HRESULT lookup_identifier(exec_ctx_t *ctx, BSTR name, vbdisp_invoke_type_
         }
     }
 
-    if(lookup_global_vars(script_obj, name, ref))
+    /* Everything up to the builtins only changes along with script_obj's bind_gen. */
+    if(lookup_bound_global(ctx, cache, ref))
         return S_OK;
-    if(lookup_global_funcs(script_obj, name, ref))
+
+    if(lookup_global_vars(script_obj, name, cache, ref))
+        return S_OK;
+    if(lookup_global_funcs(script_obj, name, cache, ref))
         return S_OK;
 
     hres = get_builtin_id(ctx->script->global_obj, name, &id);
@@ -211,6 +261,7 @@ static HRESULT lookup_identifier(exec_ctx_t *ctx, BSTR name, vbdisp_invoke_type_
         ref->type = REF_DISP;
         ref->u.d.disp = &ctx->script->global_obj->IDispatch_iface;
         ref->u.d.id = id;
+        bind_global(script_obj, cache, BIND_BUILTIN, id);
         return S_OK;
     }
 
@@ -276,6 +327,7 @@ static HRESULT add_dynamic_var(exec_ctx_t *ctx, const WCHAR *name,
             script_obj->global_vars_size = cnt * 2;
         }
         script_obj->global_vars[script_obj->global_vars_cnt++] = new_var;
+        script_disp_bindings_changed(script_obj);
     }else {
         new_var->next = ctx->dynamic_vars;
         ctx->dynamic_vars = new_var;
@@ -385,6 +437,84 @@ static HRESULT stack_pop_val(exec_ctx_t *ctx, variant_val_t *r)
     return S_OK;
 }
 
+static BOOL get_number(const VARIANT *v, double *d)
+{
+    switch(V_VT(v)) {
+    case VT_I2:
+        *d = V_I2(v);
+        return TRUE;
+    case VT_I4:
+        *d = V_I4(v);
+        return TRUE;
+    case VT_R8:
+        *d = V_R8(v);
+        return TRUE;
+    default:
+        return FALSE;
+    }
+}
+
+/*
+ * Computes +, - and * on I2, I4 and R8 operands without going through oleaut32. Integer results use
+ * VarAdd() typing: the wider operand type, promoted to I4 and then R8 on overflow.
+ */
+static BOOL numeric_binop(vbsop_t op, const VARIANT *l, const VARIANT *r, VARIANT *res)
+{
+    double dl, dr;
+
+    if((V_VT(l) == VT_I2 || V_VT(l) == VT_I4) && (V_VT(r) == VT_I2 || V_VT(r) == VT_I4)) {
+        LONGLONG a = V_VT(l) == VT_I2 ? V_I2(l) : V_I4(l);
+        LONGLONG b = V_VT(r) == VT_I2 ? V_I2(r) : V_I4(r);
+        LONGLONG n;
+
+        switch(op) {
+        case OP_add: n = a + b; break;
+        case OP_sub: n = a - b; break;
+        case OP_mul: n = a * b; break;
+        default: return FALSE;
+        }
+
+        if(V_VT(l) == VT_I2 && V_VT(r) == VT_I2 && (SHORT)n == n) {
+            V_VT(res) = VT_I2;
+            V_I2(res) = n;
+        }else if((LONG)n == n) {
+            V_VT(res) = VT_I4;
+            V_I4(res) = n;
+        }else {
+            V_VT(res) = VT_R8;
+            V_R8(res) = n;
+        }
+        return TRUE;
+    }
+
+    if((V_VT(l) != VT_R8 && V_VT(r) != VT_R8) || !get_number(l, &dl) || !get_number(r, &dr))
+        return FALSE;
+
+    switch(op) {
+    case OP_add: V_R8(res) = dl + dr; break;
+    case OP_sub: V_R8(res) = dl - dr; break;
+    case OP_mul: V_R8(res) = dl * dr; break;
+    default: return FALSE;
+    }
+    V_VT(res) = VT_R8;
+    return TRUE;
+}
+
+static HRESULT var_cmp(exec_ctx_t *ctx, VARIANT *l, VARIANT *r)
+{
+    double dl, dr;
+
+    TRACE("%s %s\n", debugstr_variant(l), debugstr_variant(r));
+
+    /* Same ordering as VarCmp() gives for numbers, including NaN comparing greater. */
+    if(get_number(l, &dl) && get_number(r, &dr))
+        return dl == dr ? VARCMP_EQ : dl < dr ? VARCMP_LT : VARCMP_GT;
+
+    /* FIXME: Fix comparing string to number */
+
+    return VarCmp(l, r, ctx->script->lcid, 0);
+}
+
 static HRESULT stack_assume_val(exec_ctx_t *ctx, unsigned n)
 {
     VARIANT *v = stack_top(ctx, n);
@@ -610,7 +740,7 @@ static HRESULT variant_call(exec_ctx_t *ctx, VARIANT *v, unsigned arg_cnt, VARIA
     return S_OK;
 }
 
-static HRESULT do_icall(exec_ctx_t *ctx, VARIANT *res, BSTR identifier, unsigned arg_cnt)
+static HRESULT do_icall(exec_ctx_t *ctx, VARIANT *res, BSTR identifier, unsigned arg_cnt, bind_cache_t *cache)
 {
     DISPPARAMS dp;
     ref_t ref;
@@ -618,7 +748,7 @@ static HRESULT do_icall(exec_ctx_t *ctx, VARIANT *res, BSTR identifier, unsigned
 
     TRACE("%s %u\n", debugstr_w(identifier), arg_cnt);
 
-    hres = lookup_identifier(ctx, identifier, VBDISP_CALLGET, &ref);
+    hres = lookup_identifier(ctx, identifier, VBDISP_CALLGET, cache, &ref);
     if(FAILED(hres))
         return hres;
 
@@ -687,7 +817,7 @@ static HRESULT interp_icall(exec_ctx_t *ctx)
 
     TRACE("\n");
 
-    hres = do_icall(ctx, &v, identifier, arg_cnt);
+    hres = do_icall(ctx, &v, identifier, arg_cnt, ctx->instr->cache);
     if(FAILED(hres))
         return hres;
 
@@ -701,7 +831,7 @@ static HRESULT interp_icallv(exec_ctx_t *ctx)
 
     TRACE("\n");
 
-    return do_icall(ctx, NULL, identifier, arg_cnt);
+    return do_icall(ctx, NULL, identifier, arg_cnt, ctx->instr->cache);
 }
 
 static HRESULT interp_vcall(exec_ctx_t *ctx)
@@ -755,7 +885,7 @@ static HRESULT do_mcall(exec_ctx_t *ctx, VARIANT *res)
 
     vbstack_to_dp(ctx, arg_cnt, FALSE, &dp);
 
-    hres = disp_get_id(obj, identifier, VBDISP_CALLGET, FALSE, &id);
+    hres = disp_get_id_cached(obj, identifier, VBDISP_CALLGET, ctx->instr->cache, &id);
     if(SUCCEEDED(hres))
         hres = disp_call(ctx->script, obj, id, &dp, res);
     IDispatch_Release(obj);
@@ -802,13 +932,35 @@ static HRESULT interp_ident(exec_ctx_t *ctx)
         return stack_push(ctx, &v);
     }
 
-    hres = do_icall(ctx, &v, identifier, 0);
+    hres = do_icall(ctx, &v, identifier, 0, ctx->instr->cache);
     if(FAILED(hres))
         return hres;
 
     return stack_push(ctx, &v);
 }
 
+static HRESULT interp_local(exec_ctx_t *ctx)
+{
+    const int ref = ctx->instr->arg1.lng;
+    const unsigned arg_cnt = ctx->instr->arg2.uint;
+    VARIANT *var = local_slot(ctx, ref);
+    VARIANT v;
+    HRESULT hres;
+
+    TRACE("%d %u\n", ref, arg_cnt);
+
+    if(arg_cnt) {
+        hres = variant_call(ctx, var, arg_cnt, &v);
+        if(FAILED(hres))
+            return hres;
+    }else {
+        V_VT(&v) = VT_BYREF|VT_VARIANT;
+        V_BYREF(&v) = V_VT(var) == (VT_VARIANT|VT_BYREF) ? V_VARIANTREF(var) : var;
+    }
+
+    return stack_push(ctx, &v);
+}
+
 static HRESULT assign_value(exec_ctx_t *ctx, VARIANT *dst, VARIANT *src, WORD flags)
 {
     VARIANT value;
@@ -835,63 +987,65 @@ static HRESULT assign_value(exec_ctx_t *ctx, VARIANT *dst, VARIANT *src, WORD fl
     return S_OK;
 }
 
-static HRESULT assign_ident(exec_ctx_t *ctx, BSTR name, WORD flags, DISPPARAMS *dp)
+static HRESULT assign_var(exec_ctx_t *ctx, VARIANT *v, WORD flags, DISPPARAMS *dp)
 {
-    ref_t ref;
     HRESULT hres;
 
-    hres = lookup_identifier(ctx, name, VBDISP_LET, &ref);
-    if(FAILED(hres))
-        return hres;
+    if(V_VT(v) == (VT_VARIANT|VT_BYREF))
+        v = V_VARIANTREF(v);
 
-    switch(ref.type) {
-    case REF_VAR: {
-        VARIANT *v = ref.u.v;
+    if(arg_cnt(dp)) {
+        SAFEARRAY *array;
 
-        if(V_VT(v) == (VT_VARIANT|VT_BYREF))
-            v = V_VARIANTREF(v);
+        if(V_VT(v) == VT_DISPATCH)
+            return disp_propput(ctx->script, V_DISPATCH(v), DISPID_VALUE, flags, dp);
 
-        if(arg_cnt(dp)) {
-            SAFEARRAY *array;
+        if(!(V_VT(v) & VT_ARRAY)) {
+            FIXME("array assign on type %d\n", V_VT(v));
+            return E_FAIL;
+        }
 
-            if(V_VT(v) == VT_DISPATCH) {
-                hres = disp_propput(ctx->script, V_DISPATCH(v), DISPID_VALUE, flags, dp);
-                break;
-            }
+        switch(V_VT(v)) {
+        case VT_ARRAY|VT_BYREF|VT_VARIANT:
+            array = *V_ARRAYREF(v);
+            break;
+        case VT_ARRAY|VT_VARIANT:
+            array = V_ARRAY(v);
+            break;
+        default:
+            FIXME("Unsupported array type %x\n", V_VT(v));
+            return E_NOTIMPL;
+        }
 
-            if(!(V_VT(v) & VT_ARRAY)) {
-                FIXME("array assign on type %d\n", V_VT(v));
-                return E_FAIL;
-            }
+        if(!array) {
+            FIXME("null array\n");
+            return E_FAIL;
+        }
 
-            switch(V_VT(v)) {
-            case VT_ARRAY|VT_BYREF|VT_VARIANT:
-                array = *V_ARRAYREF(v);
-                break;
-            case VT_ARRAY|VT_VARIANT:
-                array = V_ARRAY(v);
-                break;
-            default:
-                FIXME("Unsupported array type %x\n", V_VT(v));
-                return E_NOTIMPL;
-            }
+        hres = array_access(array, dp, &v);
+        if(FAILED(hres))
+            return hres;
+    }else if(V_VT(v) == (VT_ARRAY|VT_BYREF|VT_VARIANT)) {
+        FIXME("non-array assign\n");
+        return E_NOTIMPL;
+    }
 
-            if(!array) {
-                FIXME("null array\n");
-                return E_FAIL;
-            }
+    return assign_value(ctx, v, dp->rgvarg, flags);
+}
 
-            hres = array_access(array, dp, &v);
-            if(FAILED(hres))
-                return hres;
-        }else if(V_VT(v) == (VT_ARRAY|VT_BYREF|VT_VARIANT)) {
-            FIXME("non-array assign\n");
-            return E_NOTIMPL;
-        }
+static HRESULT assign_ident(exec_ctx_t *ctx, BSTR name, WORD flags, DISPPARAMS *dp, bind_cache_t *cache)
+{
+    ref_t ref;
+    HRESULT hres;
 
-        hres = assign_value(ctx, v, dp->rgvarg, flags);
+    hres = lookup_identifier(ctx, name, VBDISP_LET, cache, &ref);
+    if(FAILED(hres))
+        return hres;
+
+    switch(ref.type) {
+    case REF_VAR:
+        hres = assign_var(ctx, ref.u.v, flags, dp);
         break;
-    }
     case REF_DISP:
         hres = disp_propput(ctx->script, ref.u.d.disp, ref.u.d.id, flags, dp);
         break;
@@ -936,7 +1090,7 @@ static HRESULT interp_assign_ident(exec_ctx_t *ctx)
     TRACE("%s\n", debugstr_w(arg));
 
     vbstack_to_dp(ctx, arg_cnt, TRUE, &dp);
-    hres = assign_ident(ctx, arg, DISPATCH_PROPERTYPUT, &dp);
+    hres = assign_ident(ctx, arg, DISPATCH_PROPERTYPUT, &dp, ctx->instr->cache);
     if(FAILED(hres))
         return hres;
 
@@ -958,7 +1112,47 @@ static HRESULT interp_set_ident(exec_ctx_t *ctx)
         return hres;
 
     vbstack_to_dp(ctx, arg_cnt, TRUE, &dp);
-    hres = assign_ident(ctx, arg, DISPATCH_PROPERTYPUTREF, &dp);
+    hres = assign_ident(ctx, arg, DISPATCH_PROPERTYPUTREF, &dp, ctx->instr->cache);
+    if(FAILED(hres))
+        return hres;
+
+    stack_popn(ctx, arg_cnt + 1);
+    return S_OK;
+}
+
+static HRESULT interp_assign_local(exec_ctx_t *ctx)
+{
+    const int ref = ctx->instr->arg1.lng;
+    const unsigned arg_cnt = ctx->instr->arg2.uint;
+    DISPPARAMS dp;
+    HRESULT hres;
+
+    TRACE("%d %u\n", ref, arg_cnt);
+
+    vbstack_to_dp(ctx, arg_cnt, TRUE, &dp);
+    hres = assign_var(ctx, local_slot(ctx, ref), DISPATCH_PROPERTYPUT, &dp);
+    if(FAILED(hres))
+        return hres;
+
+    stack_popn(ctx, arg_cnt+1);
+    return S_OK;
+}
+
+static HRESULT interp_set_local(exec_ctx_t *ctx)
+{
+    const int ref = ctx->instr->arg1.lng;
+    const unsigned arg_cnt = ctx->instr->arg2.uint;
+    DISPPARAMS dp;
+    HRESULT hres;
+
+    TRACE("%d %u\n", ref, arg_cnt);
+
+    hres = stack_assume_disp(ctx, arg_cnt, NULL);
+    if(FAILED(hres))
+        return hres;
+
+    vbstack_to_dp(ctx, arg_cnt, TRUE, &dp);
+    hres = assign_var(ctx, local_slot(ctx, ref), DISPATCH_PROPERTYPUTREF, &dp);
     if(FAILED(hres))
         return hres;
 
@@ -986,7 +1180,7 @@ static HRESULT interp_assign_member(exec_ctx_t *ctx)
         return E_FAIL;
     }
 
-    hres = disp_get_id(obj, identifier, VBDISP_LET, FALSE, &id);
+    hres = disp_get_id_cached(obj, identifier, VBDISP_LET, ctx->instr->cache, &id);
     if(SUCCEEDED(hres)) {
         vbstack_to_dp(ctx, arg_cnt, TRUE, &dp);
         hres = disp_propput(ctx->script, obj, id, DISPATCH_PROPERTYPUT, &dp);
@@ -1022,7 +1216,7 @@ static HRESULT interp_set_member(exec_ctx_t *ctx)
     if(FAILED(hres))
         return hres;
 
-    hres = disp_get_id(obj, identifier, VBDISP_SET, FALSE, &id);
+    hres = disp_get_id_cached(obj, identifier, VBDISP_SET, ctx->instr->cache, &id);
     if(SUCCEEDED(hres)) {
         vbstack_to_dp(ctx, arg_cnt, TRUE, &dp);
         hres = disp_propput(ctx->script, obj, id, DISPATCH_PROPERTYPUTREF, &dp);
@@ -1045,7 +1239,7 @@ static HRESULT interp_const(exec_ctx_t *ctx)
 
     assert(ctx->func->type == FUNC_GLOBAL);
 
-    hres = lookup_identifier(ctx, arg, VBDISP_CALLGET, &ref);
+    hres = lookup_identifier(ctx, arg, VBDISP_CALLGET, NULL, &ref);
     if(FAILED(hres))
         return hres;
 
@@ -1239,7 +1433,7 @@ static HRESULT interp_dim(exec_ctx_t *ctx)
                 return E_OUTOFMEMORY;
         }
 
-        hres = lookup_identifier(ctx, ident, VBDISP_LET, &ref);
+        hres = lookup_identifier(ctx, ident, VBDISP_LET, NULL, &ref);
         if(FAILED(hres)) {
             FIXME("lookup %s failed: %08lx\n", debugstr_w(ident), hres);
             return hres;
@@ -1310,7 +1504,7 @@ static HRESULT interp_redim(exec_ctx_t *ctx)
 
     TRACE("%s %u\n", debugstr_w(identifier), dim_cnt);
 
-    hres = lookup_identifier(ctx, identifier, VBDISP_LET, &ref);
+    hres = lookup_identifier(ctx, identifier, VBDISP_LET, NULL, &ref);
     if(FAILED(hres)) {
         FIXME("lookup %s failed: %08lx\n", debugstr_w(identifier), hres);
         return hres;
@@ -1362,7 +1556,7 @@ static HRESULT interp_redim_preserve(exec_ctx_t *ctx)
 
     TRACE("%s %u\n", debugstr_w(identifier), dim_cnt);
 
-    hres = lookup_identifier(ctx, identifier, VBDISP_LET, &ref);
+    hres = lookup_identifier(ctx, identifier, VBDISP_LET, NULL, &ref);
     if(FAILED(hres)) {
         FIXME("lookup %s failed: %08lx\n", debugstr_w(identifier), hres);
         return hres;
@@ -1420,34 +1614,21 @@ static HRESULT interp_redim_preserve(exec_ctx_t *ctx)
     return hres;
 }
 
-static HRESULT interp_step(exec_ctx_t *ctx)
+static HRESULT do_step(exec_ctx_t *ctx, VARIANT *var)
 {
-    const BSTR ident = ctx->instr->arg2.bstr;
     BOOL gteq_zero;
     VARIANT zero;
-    ref_t ref;
     HRESULT hres;
 
-    TRACE("%s\n", debugstr_w(ident));
-
     V_VT(&zero) = VT_I2;
     V_I2(&zero) = 0;
-    hres = VarCmp(stack_top(ctx, 0), &zero, ctx->script->lcid, 0);
+    hres = var_cmp(ctx, stack_top(ctx, 0), &zero);
     if(FAILED(hres))
         return hres;
 
     gteq_zero = hres == VARCMP_GT || hres == VARCMP_EQ;
 
-    hres = lookup_identifier(ctx, ident, VBDISP_ANY, &ref);
-    if(FAILED(hres))
-        return hres;
-
-    if(ref.type != REF_VAR) {
-        FIXME("%s is not REF_VAR\n", debugstr_w(ident));
-        return E_FAIL;
-    }
-
-    hres = VarCmp(ref.u.v, stack_top(ctx, 1), ctx->script->lcid, 0);
+    hres = var_cmp(ctx, var, stack_top(ctx, 1));
     if(FAILED(hres))
         return hres;
 
@@ -1460,6 +1641,35 @@ static HRESULT interp_step(exec_ctx_t *ctx)
     return S_OK;
 }
 
+static HRESULT interp_step(exec_ctx_t *ctx)
+{
+    const BSTR ident = ctx->instr->arg2.bstr;
+    ref_t ref;
+    HRESULT hres;
+
+    TRACE("%s\n", debugstr_w(ident));
+
+    hres = lookup_identifier(ctx, ident, VBDISP_ANY, NULL, &ref);
+    if(FAILED(hres))
+        return hres;
+
+    if(ref.type != REF_VAR) {
+        FIXME("%s is not REF_VAR\n", debugstr_w(ident));
+        return E_FAIL;
+    }
+
+    return do_step(ctx, ref.u.v);
+}
+
+static HRESULT interp_step_local(exec_ctx_t *ctx)
+{
+    const int ref = ctx->instr->arg2.lng;
+
+    TRACE("%d\n", ref);
+
+    return do_step(ctx, local_slot(ctx, ref));
+}
+
 static HRESULT interp_newenum(exec_ctx_t *ctx)
 {
     variant_val_t v;
@@ -1548,7 +1758,7 @@ static HRESULT interp_enumnext(exec_ctx_t *ctx)
         return hres;
 
     do_continue = hres == S_OK;
-    hres = assign_ident(ctx, ident, DISPATCH_PROPERTYPUT|DISPATCH_PROPERTYPUTREF, &dp);
+    hres = assign_ident(ctx, ident, DISPATCH_PROPERTYPUT|DISPATCH_PROPERTYPUTREF, &dp, NULL);
     VariantClear(&v);
     if(FAILED(hres))
         return hres;
@@ -1937,15 +2147,6 @@ static HRESULT interp_imp(exec_ctx_t *ctx)
     return stack_push(ctx, &v);
 }
 
-static HRESULT var_cmp(exec_ctx_t *ctx, VARIANT *l, VARIANT *r)
-{
-    TRACE("%s %s\n", debugstr_variant(l), debugstr_variant(r));
-
-    /* FIXME: Fix comparing string to number */
-
-    return VarCmp(l, r, ctx->script->lcid, 0);
- }
-
 static HRESULT cmp_oper(exec_ctx_t *ctx)
 {
     variant_val_t l, r;
@@ -2191,7 +2392,8 @@ static HRESULT interp_add(exec_ctx_t *ctx)
 
     hres = stack_pop_val(ctx, &l);
     if(SUCCEEDED(hres)) {
-        hres = VarAdd(l.v, r.v, &v);
+        if(!numeric_binop(OP_add, l.v, r.v, &v))
+            hres = VarAdd(l.v, r.v, &v);
         release_val(&l);
     }
     release_val(&r);
@@ -2215,7 +2417,8 @@ static HRESULT interp_sub(exec_ctx_t *ctx)
 
     hres = stack_pop_val(ctx, &l);
     if(SUCCEEDED(hres)) {
-        hres = VarSub(l.v, r.v, &v);
+        if(!numeric_binop(OP_sub, l.v, r.v, &v))
+            hres = VarSub(l.v, r.v, &v);
         release_val(&l);
     }
     release_val(&r);
@@ -2311,7 +2514,8 @@ static HRESULT interp_mul(exec_ctx_t *ctx)
 
     hres = stack_pop_val(ctx, &l);
     if(SUCCEEDED(hres)) {
-        hres = VarMul(l.v, r.v, &v);
+        if(!numeric_binop(OP_mul, l.v, r.v, &v))
+            hres = VarMul(l.v, r.v, &v);
         release_val(&l);
     }
     release_val(&r);
@@ -2363,16 +2567,31 @@ static HRESULT interp_neg(exec_ctx_t *ctx)
     return stack_push(ctx, &v);
 }
 
+static HRESULT do_incc(exec_ctx_t *ctx, VARIANT *var)
+{
+    VARIANT v;
+    HRESULT hres;
+
+    if(!numeric_binop(OP_add, stack_top(ctx, 0), var, &v)) {
+        hres = VarAdd(stack_top(ctx, 0), var, &v);
+        if(FAILED(hres))
+            return hres;
+    }
+
+    VariantClear(var);
+    *var = v;
+    return S_OK;
+}
+
 static HRESULT interp_incc(exec_ctx_t *ctx)
 {
     const BSTR ident = ctx->instr->arg1.bstr;
-    VARIANT v;
     ref_t ref;
     HRESULT hres;
 
     TRACE("\n");
 
-    hres = lookup_identifier(ctx, ident, VBDISP_LET, &ref);
+    hres = lookup_identifier(ctx, ident, VBDISP_LET, NULL, &ref);
     if(FAILED(hres))
         return hres;
 
@@ -2381,13 +2600,16 @@ static HRESULT interp_incc(exec_ctx_t *ctx)
         return E_FAIL;
     }
 
-    hres = VarAdd(stack_top(ctx, 0), ref.u.v, &v);
-    if(FAILED(hres))
-        return hres;
+    return do_incc(ctx, ref.u.v);
+}
 
-    VariantClear(ref.u.v);
-    *ref.u.v = v;
-    return S_OK;
+static HRESULT interp_incc_local(exec_ctx_t *ctx)
+{
+    const int ref = ctx->instr->arg1.lng;
+
+    TRACE("%d\n", ref);
+
+    return do_incc(ctx, local_slot(ctx, ref));
 }
 
 static HRESULT interp_catch(exec_ctx_t *ctx)
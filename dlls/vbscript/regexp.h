@@ -58,6 +58,12 @@ typedef struct regexp_t {
     struct RECharSet    *classList;    /* list of [...] bitmaps */
     const WCHAR         *source;       /* locked source string, sans // */
     DWORD               source_len;
+    BYTE                prefilter;     /* REOP_FLAT or REOP_CLASS if every match starts with one */
+    WCHAR               prefix_chr;    /* storage for a single character prefix */
+    const WCHAR         *prefix;       /* literal every match starts with */
+    size_t              prefix_len;
+    size_t              prefix_class;  /* index of the class every match starts with */
+    BYTE                prefix_skip[256]; /* Horspool shift table for prefix */
     jsbytecode          program[1];    /* regular expression bytecode */
 } regexp_t;
 
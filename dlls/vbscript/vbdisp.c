@@ -34,21 +34,31 @@ static inline BOOL is_func_id(vbdisp_t *This, DISPID id)
     return id < This->desc->func_cnt;
 }
 
+static BOOL func_matches(const vbdisp_funcprop_desc_t *func, const WCHAR *name, vbdisp_invoke_type_t invoke_type,
+        BOOL search_private)
+{
+    if(invoke_type == VBDISP_ANY) {
+        if(!search_private && !func->is_public)
+            return FALSE;
+    }else {
+        if(!func->entries[invoke_type] || (!search_private && !func->entries[invoke_type]->is_public))
+            return FALSE;
+    }
+
+    return func->name && !wcsicmp(func->name, name);
+}
+
+static BOOL prop_matches(const vbdisp_prop_desc_t *prop, const WCHAR *name, BOOL search_private)
+{
+    return (search_private || prop->is_public) && !wcsicmp(prop->name, name);
+}
+
 static BOOL get_func_id(vbdisp_t *This, const WCHAR *name, vbdisp_invoke_type_t invoke_type, BOOL search_private, DISPID *id)
 {
     unsigned i;
 
     for(i = 0; i < This->desc->func_cnt; i++) {
-        if(invoke_type == VBDISP_ANY) {
-            if(!search_private && !This->desc->funcs[i].is_public)
-                continue;
-        }else {
-            if(!This->desc->funcs[i].entries[invoke_type]
-                || (!search_private && !This->desc->funcs[i].entries[invoke_type]->is_public))
-                continue;
-        }
-
-        if(This->desc->funcs[i].name && !wcsicmp(This->desc->funcs[i].name, name)) {
+        if(func_matches(This->desc->funcs + i, name, invoke_type, search_private)) {
             *id = i;
             return TRUE;
         }
@@ -65,10 +75,7 @@ HRESULT vbdisp_get_id(vbdisp_t *This, BSTR name, vbdisp_invoke_type_t invoke_typ
         return S_OK;
 
     for(i=0; i < This->desc->prop_cnt; i++) {
-        if(!search_private && !This->desc->props[i].is_public)
-            continue;
-
-        if(!wcsicmp(This->desc->props[i].name, name)) {
+        if(prop_matches(This->desc->props + i, name, search_private)) {
             *id = i + This->desc->func_cnt;
             return S_OK;
         }
@@ -78,6 +85,18 @@ HRESULT vbdisp_get_id(vbdisp_t *This, BSTR name, vbdisp_invoke_type_t invoke_typ
     return DISP_E_UNKNOWNNAME;
 }
 
+/* Member names are unique within a class, so an entry that still matches is the one a full lookup would find. */
+static BOOL vbdisp_check_id(vbdisp_t *This, BSTR name, vbdisp_invoke_type_t invoke_type, DISPID id)
+{
+    if(id < 0)
+        return FALSE;
+    if(is_func_id(This, id))
+        return func_matches(This->desc->funcs + id, name, invoke_type, FALSE);
+    if(id - This->desc->func_cnt < This->desc->prop_cnt)
+        return prop_matches(This->desc->props + id - This->desc->func_cnt, name, FALSE);
+    return FALSE;
+}
+
 static HRESULT get_propput_arg(script_ctx_t *ctx, const DISPPARAMS *dp, WORD flags, VARIANT *v, BOOL *is_owned)
 {
     unsigned i;
@@ -1542,6 +1561,14 @@ static IDispatchExVtbl ScriptDispVtbl = {
     ScriptDisp_GetNameSpaceParent
 };
 
+static LONG bind_gen_counter;
+
+/* Generations are unique across all script objects, so a cached binding can't match a recycled object. */
+void script_disp_bindings_changed(ScriptDisp *obj)
+{
+    obj->bind_gen = InterlockedIncrement(&bind_gen_counter);
+}
+
 HRESULT create_script_disp(script_ctx_t *ctx, ScriptDisp **ret)
 {
     ScriptDisp *script_disp;
@@ -1555,6 +1582,7 @@ HRESULT create_script_disp(script_ctx_t *ctx, ScriptDisp **ret)
     script_disp->ctx = ctx;
     heap_pool_init(&script_disp->heap);
     script_disp->rnd = 0x50000;
+    script_disp_bindings_changed(script_disp);
 
     *ret = script_disp;
     return S_OK;
@@ -1600,6 +1628,34 @@ HRESULT disp_get_id(IDispatch *disp, BSTR name, vbdisp_invoke_type_t invoke_type
     return hres;
 }
 
+/*
+ * Same as disp_get_id() for public members, remembering the result for script class instances. Other
+ * objects are always asked again: their DISPIDs are only guaranteed for the object they came from.
+ */
+HRESULT disp_get_id_cached(IDispatch *disp, BSTR name, vbdisp_invoke_type_t invoke_type, bind_cache_t *cache, DISPID *id)
+{
+    vbdisp_t *vbdisp;
+    HRESULT hres;
+
+    vbdisp = unsafe_impl_from_IDispatch(disp);
+    if(!cache || !vbdisp || !vbdisp->desc)
+        return disp_get_id(disp, name, invoke_type, FALSE, id);
+
+    if(cache->type == BIND_MEMBER && cache->desc == vbdisp->desc
+       && vbdisp_check_id(vbdisp, name, invoke_type, cache->id)) {
+        *id = cache->id;
+        return S_OK;
+    }
+
+    hres = vbdisp_get_id(vbdisp, name, invoke_type, FALSE, id);
+    if(SUCCEEDED(hres)) {
+        cache->type = BIND_MEMBER;
+        cache->desc = vbdisp->desc;
+        cache->id = *id;
+    }
+    return hres;
+}
+
 #define RPC_E_SERVER_UNAVAILABLE 0x800706ba
 
 void map_vbs_exception(EXCEPINFO *ei)
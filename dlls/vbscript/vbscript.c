@@ -168,6 +168,8 @@ static HRESULT exec_global_code(script_ctx_t *ctx, vbscode_t *code, VARIANT *res
             obj->global_funcs[obj->global_funcs_cnt++] = func_iter;
     }
 
+    script_disp_bindings_changed(obj);
+
     if (code->classes)
     {
         class_desc_t *class = code->classes;
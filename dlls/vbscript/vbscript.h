@@ -137,6 +137,9 @@ typedef struct {
     heap_pool_t heap;
 
     unsigned int rnd;
+
+    /* Changed whenever global_vars or global_funcs change, see bind_cache_t. */
+    LONG bind_gen;
 } ScriptDisp;
 
 typedef struct _builtin_prop_t builtin_prop_t;
@@ -234,6 +237,7 @@ typedef enum {
     X(add,            1, 0,           0)          \
     X(and,            1, 0,           0)          \
     X(assign_ident,   1, ARG_BSTR,    ARG_UINT)   \
+    X(assign_local,   1, ARG_INT,     ARG_UINT)   \
     X(assign_member,  1, ARG_BSTR,    ARG_UINT)   \
     X(bool,           1, ARG_INT,     0)          \
     X(catch,          1, ARG_ADDR,    ARG_UINT)   \
@@ -260,11 +264,13 @@ typedef enum {
     X(idiv,           1, 0,           0)          \
     X(imp,            1, 0,           0)          \
     X(incc,           1, ARG_BSTR,    0)          \
+    X(incc_local,     1, ARG_INT,     0)          \
     X(int,            1, ARG_INT,     0)          \
     X(is,             1, 0,           0)          \
     X(jmp,            0, ARG_ADDR,    0)          \
     X(jmp_false,      0, ARG_ADDR,    0)          \
     X(jmp_true,       0, ARG_ADDR,    0)          \
+    X(local,          1, ARG_INT,     ARG_UINT)   \
     X(lt,             1, 0,           0)          \
     X(lteq,           1, 0,           0)          \
     X(mcall,          1, ARG_BSTR,    ARG_UINT)   \
@@ -287,9 +293,11 @@ typedef enum {
     X(ret,            0, 0,           0)          \
     X(retval,         1, 0,           0)          \
     X(set_ident,      1, ARG_BSTR,    ARG_UINT)   \
+    X(set_local,      1, ARG_INT,     ARG_UINT)   \
     X(set_member,     1, ARG_BSTR,    ARG_UINT)   \
     X(stack,          1, ARG_UINT,    0)          \
     X(step,           0, ARG_ADDR,    ARG_BSTR)   \
+    X(step_local,     0, ARG_ADDR,    ARG_INT)    \
     X(stop,           1, 0,           0)          \
     X(string,         1, ARG_STR,     0)          \
     X(sub,            1, 0,           0)          \
@@ -314,11 +322,32 @@ typedef union {
     DATE *date;
 } instr_arg_t;
 
+typedef enum {
+    BIND_NONE,
+    BIND_GLOBAL_VAR,
+    BIND_GLOBAL_FUNC,
+    BIND_BUILTIN,
+    BIND_MEMBER
+} bind_type_t;
+
+/*
+ * Binding last resolved by an instruction that names a global identifier or an object member.
+ * Global bindings are valid as long as the script object's bind_gen matches gen. Member
+ * bindings are only kept for script class instances and are rechecked against the class.
+ */
+typedef struct {
+    bind_type_t type;
+    LONG gen;
+    const class_desc_t *desc;
+    DISPID id;
+} bind_cache_t;
+
 typedef struct {
     vbsop_t op;
     unsigned loc;
     instr_arg_t arg1;
     instr_arg_t arg2;
+    bind_cache_t *cache;
 } instr_t;
 
 typedef struct {
@@ -397,6 +426,8 @@ void clear_ei(EXCEPINFO*);
 HRESULT report_script_error(script_ctx_t*,const vbscode_t*,unsigned);
 void detach_global_objects(script_ctx_t*);
 HRESULT get_builtin_id(BuiltinDisp*,const WCHAR*,DISPID*);
+HRESULT disp_get_id_cached(IDispatch*,BSTR,vbdisp_invoke_type_t,bind_cache_t*,DISPID*);
+void script_disp_bindings_changed(ScriptDisp*);
 HRESULT array_access(SAFEARRAY *array, DISPPARAMS *dp, VARIANT **ret);
 
 void release_regexp_typelib(void);
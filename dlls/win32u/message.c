@@ -3443,6 +3443,12 @@ static BOOL put_message_in_queue( const struct send_message_info *info, size_t *
         req->timeout = timeout;
 
         if (info->flags & SMTO_ABORTIFHUNG) req->flags |= SEND_MSG_ABORT_IF_HUNG;
+        if (info->type != MSG_NOTIFY && info->type != MSG_CALLBACK && info->type != MSG_POSTED)
+        {
+            /* let the server prepare our queue for wait_message_reply */
+            req->flags |= SEND_MSG_WAIT_REPLY;
+            if (info->flags & SMTO_BLOCK) req->flags |= SEND_MSG_BLOCK;
+        }
         for (i = 0; i < data.count; i++) wine_server_add_data( req, data.data[i], data.size[i] );
         res = wine_server_call( req );
     }
@@ -1858,6 +1858,15 @@ static BOOL REGION_IntersectRegion(WINEREGION *newReg, WINEREGION *reg1,
     if ( (!(reg1->numRects)) || (!(reg2->numRects))  ||
 	(!overlapping(&reg1->extents, &reg2->extents)))
 	newReg->numRects = 0;
+    else if (reg1->numRects == 1 && reg2->numRects == 1)
+    {
+        /* fast path for the common rectangle/rectangle case */
+        RECT rect;
+
+        intersect_rect( &rect, &reg1->extents, &reg2->extents );
+        newReg->rects[0] = rect;
+        newReg->numRects = 1;
+    }
     else
 	if (!REGION_RegionOp (newReg, reg1, reg2, REGION_IntersectO, NULL, NULL)) return FALSE;
 
@@ -3765,6 +3765,8 @@ VkCommandBuffer wined3d_context_vk_apply_draw_state(struct wined3d_context_vk *c
     uint32_t null_buffer_binding;
     bool invalidate_ds = false;
 
+    context_vk->shaders_pending = 0;
+
     if (wined3d_context_is_graphics_state_dirty(&context_vk->c, STATE_SHADER(WINED3D_SHADER_TYPE_PIXEL))
             || wined3d_context_is_graphics_state_dirty(&context_vk->c, STATE_FRAMEBUFFER)
             || dual_source_blend != context_vk->c.last_was_dual_source_blend)
@@ -3835,7 +3837,10 @@ VkCommandBuffer wined3d_context_vk_apply_draw_state(struct wined3d_context_vk *c
         device_vk->d.shader_backend->shader_apply_draw_state(device_vk->d.shader_priv, &context_vk->c, state);
         if (!context_vk->graphics.vk_pipeline_layout)
         {
-            ERR("No pipeline layout set.\n");
+            if (context_vk->shaders_pending)
+                TRACE("Shaders are still being compiled, skipping draw.\n");
+            else
+                ERR("No pipeline layout set.\n");
             return VK_NULL_HANDLE;
         }
         context_vk->c.update_shader_resource_bindings = 1;
@@ -30,6 +30,19 @@ static NTSTATUS (WINAPI *pNtAlertThreadByThreadId)(HANDLE tid);
 static NTSTATUS (WINAPI *pNtWaitForAlertByThreadId)(void *addr, const LARGE_INTEGER *timeout);
 
 #define WINED3D_INITIAL_CS_SIZE 4096
+#define WINED3D_CS_CHUNK_MIN_SIZE 0x400
+#define WINED3D_CS_CHUNK_MAX_SIZE 0x100000
+
+/* Deferred contexts record into a list of chunks. The chunks are handed over
+ * to the command list as-is when it is recorded, and executed from there, so
+ * the command data is never copied or reallocated once written. Each chunk is
+ * twice the size of the previous one, so small command lists stay small. */
+struct wined3d_cs_chunk
+{
+    struct wined3d_cs_chunk *next;
+    SIZE_T size, capacity;
+    DECLSPEC_ALIGN(8) BYTE data[];
+};
 
 struct wined3d_deferred_upload
 {
@@ -53,8 +66,7 @@ struct wined3d_command_list
 
     struct wined3d_device *device;
 
-    SIZE_T data_size;
-    void *data;
+    struct wined3d_cs_chunk *chunks;
 
     SIZE_T resource_count;
     struct wined3d_resource **resources;
@@ -632,6 +644,17 @@ static struct wined3d_cs_packet *wined3d_next_cs_packet(const uint8_t *data, SIZ
     return packet;
 }
 
+static void wined3d_cs_chunks_free(struct wined3d_cs_chunk *chunk)
+{
+    struct wined3d_cs_chunk *next;
+
+    for (; chunk; chunk = next)
+    {
+        next = chunk->next;
+        free(chunk);
+    }
+}
+
 static void wined3d_cs_exec_nop(struct wined3d_cs *cs, const void *data)
 {
 }
@@ -3372,34 +3395,39 @@ static inline bool wined3d_cs_execute_next(struct wined3d_cs *cs, struct wined3d
 static void wined3d_cs_exec_execute_command_list(struct wined3d_cs *cs, const void *data)
 {
     const struct wined3d_cs_execute_command_list *op = data;
-    SIZE_T start = 0, end = op->list->data_size;
-    const BYTE *cs_data = op->list->data;
+    const struct wined3d_cs_chunk *chunk;
     struct wined3d_cs_queue *queue;
+    SIZE_T start;
 
     TRACE("Executing command list %p.\n", op->list);
 
     queue = &cs->queue[WINED3D_CS_QUEUE_MAP];
-    while (start < end)
+    for (chunk = op->list->chunks; chunk; chunk = chunk->next)
     {
-        const struct wined3d_cs_packet *packet;
-        enum wined3d_cs_op opcode;
+        start = 0;
+        while (start < chunk->size)
+        {
+            const struct wined3d_cs_packet *packet;
+            enum wined3d_cs_op opcode;
 
-        while (!wined3d_cs_queue_is_empty(cs, queue))
-            wined3d_cs_execute_next(cs, queue);
+            while (!wined3d_cs_queue_is_empty(cs, queue))
+                wined3d_cs_execute_next(cs, queue);
 
-        packet = wined3d_next_cs_packet(cs_data, &start, WINED3D_CS_QUEUE_MASK);
-        opcode = *(const enum wined3d_cs_op *)packet->data;
+            packet = wined3d_next_cs_packet(chunk->data, &start, ~(SIZE_T)0);
+            opcode = *(const enum wined3d_cs_op *)packet->data;
 
-        if (opcode >= WINED3D_CS_OP_STOP)
-            ERR("Invalid opcode %#x.\n", opcode);
-        else
-            wined3d_cs_op_handlers[opcode](cs, packet->data);
-        TRACE("%s executed.\n", debug_cs_op(opcode));
+            if (opcode >= WINED3D_CS_OP_STOP)
+                ERR("Invalid opcode %#x.\n", opcode);
+            else
+                wined3d_cs_op_handlers[opcode](cs, packet->data);
+            TRACE("%s executed.\n", debug_cs_op(opcode));
+        }
     }
 }
 
 static DWORD WINAPI wined3d_cs_run(void *ctx)
 {
+    unsigned int spin_limit = WINED3D_CS_SPIN_COUNT;
     struct wined3d_cs_queue *queue;
     unsigned int spin_count = 0;
     struct wined3d_cs *cs = ctx;
@@ -3433,16 +3461,27 @@ static DWORD WINAPI wined3d_cs_run(void *ctx)
             if (wined3d_cs_queue_is_empty(cs, queue))
             {
                 YieldProcessor();
-                if (++spin_count >= WINED3D_CS_SPIN_COUNT)
+                if (++spin_count >= spin_limit)
                 {
                     if (poll)
+                    {
                         poll = WINED3D_CS_QUERY_POLL_INTERVAL - 1;
+                    }
                     else
+                    {
+                        /* Spinning didn't pay off; spin less before
+                         * going to sleep next time. */
+                        spin_limit = max(spin_limit / 2, WINED3D_CS_SPIN_COUNT_MIN);
                         wined3d_cs_wait_event(cs);
+                    }
                 }
                 continue;
             }
         }
+        /* Work arrived while we were spinning, which saved us a wakeup.
+         * Spin a little longer next time. */
+        if (spin_count && spin_count < spin_limit)
+            spin_limit = min(spin_limit * 2, WINED3D_CS_SPIN_COUNT_MAX);
         spin_count = 0;
 
         run = wined3d_cs_execute_next(cs, queue);
@@ -3841,6 +3880,22 @@ static void wined3d_cs_packet_decref_objects(const struct wined3d_cs_packet *pac
     }
 }
 
+static void wined3d_cs_chunks_decref_objects(const struct wined3d_cs_chunk *chunk)
+{
+    const struct wined3d_cs_packet *packet;
+    SIZE_T offset;
+
+    for (; chunk; chunk = chunk->next)
+    {
+        offset = 0;
+        while (offset < chunk->size)
+        {
+            packet = wined3d_next_cs_packet(chunk->data, &offset, ~(SIZE_T)0);
+            wined3d_cs_packet_decref_objects(packet);
+        }
+    }
+}
+
 static void wined3d_cs_packet_incref_objects(struct wined3d_cs_packet *packet)
 {
     enum wined3d_cs_op opcode = *(const enum wined3d_cs_op *)packet->data;
@@ -4086,8 +4141,7 @@ struct wined3d_deferred_context
 {
     struct wined3d_device_context c;
 
-    SIZE_T data_size, data_capacity;
-    void *data;
+    struct wined3d_cs_chunk *chunks, *last_chunk;
 
     SIZE_T resource_count, resources_capacity;
     struct wined3d_resource **resources;
@@ -4117,6 +4171,7 @@ static void *wined3d_deferred_context_require_space(struct wined3d_device_contex
         size_t size, enum wined3d_cs_queue_id queue_id)
 {
     struct wined3d_deferred_context *deferred = wined3d_deferred_context_from_context(context);
+    struct wined3d_cs_chunk *chunk = deferred->last_chunk;
     struct wined3d_cs_packet *packet;
     size_t header_size, packet_size;
 
@@ -4125,13 +4180,30 @@ static void *wined3d_deferred_context_require_space(struct wined3d_device_contex
 
     header_size = offsetof(struct wined3d_cs_packet, data[0]);
     packet_size = offsetof(struct wined3d_cs_packet, data[size]);
-    packet_size = (packet_size + header_size - 1) & ~(header_size - 1);
+    /* Keep packets 8-byte aligned within the chunk, also on 32-bit. */
+    packet_size = (packet_size + sizeof(UINT64) - 1) & ~(sizeof(UINT64) - 1);
 
-    if (!wined3d_array_reserve(&deferred->data, &deferred->data_capacity, deferred->data_size + packet_size, 1))
-        return NULL;
+    if (!chunk || chunk->capacity - chunk->size < packet_size)
+    {
+        size_t capacity = chunk ? min(chunk->capacity * 2, WINED3D_CS_CHUNK_MAX_SIZE) : WINED3D_CS_CHUNK_MIN_SIZE;
+
+        capacity = max(capacity, packet_size);
+
+        if (!(chunk = malloc(offsetof(struct wined3d_cs_chunk, data[capacity]))))
+            return NULL;
+        chunk->next = NULL;
+        chunk->size = 0;
+        chunk->capacity = capacity;
+
+        if (deferred->last_chunk)
+            deferred->last_chunk->next = chunk;
+        else
+            deferred->chunks = chunk;
+        deferred->last_chunk = chunk;
+    }
 
-    packet = (struct wined3d_cs_packet *)((BYTE *)deferred->data + deferred->data_size);
-    TRACE("size was %Iu, adding %Iu\n", (size_t)deferred->data_size, packet_size);
+    packet = (struct wined3d_cs_packet *)&chunk->data[chunk->size];
+    TRACE("size was %Iu, adding %Iu\n", (size_t)chunk->size, packet_size);
     packet->size = packet_size - header_size;
     return &packet->data;
 }
@@ -4142,7 +4214,7 @@ static void wined3d_deferred_context_submit(struct wined3d_device_context *conte
     struct wined3d_cs_packet *packet;
 
     assert(queue_id == WINED3D_CS_QUEUE_DEFAULT);
-    packet = wined3d_next_cs_packet(deferred->data, &deferred->data_size, ~(SIZE_T)0);
+    packet = wined3d_next_cs_packet(deferred->last_chunk->data, &deferred->last_chunk->size, ~(SIZE_T)0);
     wined3d_cs_packet_incref_objects(packet);
 }
 
@@ -4389,8 +4461,7 @@ HRESULT CDECL wined3d_deferred_context_create(struct wined3d_device *device, str
 void CDECL wined3d_deferred_context_destroy(struct wined3d_device_context *context)
 {
     struct wined3d_deferred_context *deferred = wined3d_deferred_context_from_context(context);
-    const struct wined3d_cs_packet *packet;
-    SIZE_T i, offset = 0;
+    SIZE_T i;
 
     TRACE("context %p.\n", context);
 
@@ -4423,14 +4494,10 @@ void CDECL wined3d_deferred_context_destroy(struct wined3d_device_context *conte
         wined3d_query_decref(deferred->queries[i].query);
     free(deferred->queries);
 
-    while (offset < deferred->data_size)
-    {
-        packet = wined3d_next_cs_packet(deferred->data, &offset, ~(SIZE_T)0);
-        wined3d_cs_packet_decref_objects(packet);
-    }
+    wined3d_cs_chunks_decref_objects(deferred->chunks);
 
     wined3d_state_destroy(deferred->c.state);
-    free(deferred->data);
+    wined3d_cs_chunks_free(deferred->chunks);
     free(deferred);
 }
 
@@ -4447,8 +4514,7 @@ HRESULT CDECL wined3d_deferred_context_record_command_list(struct wined3d_device
     memory = malloc(sizeof(*object) + deferred->resource_count * sizeof(*object->resources)
             + deferred->upload_count * sizeof(*object->uploads)
             + deferred->command_list_count * sizeof(*object->command_lists)
-            + deferred->query_count * sizeof(*object->queries)
-            + deferred->data_size);
+            + deferred->query_count * sizeof(*object->queries));
 
     if (!memory)
     {
@@ -4487,11 +4553,10 @@ HRESULT CDECL wined3d_deferred_context_record_command_list(struct wined3d_device
     memcpy(object->queries, deferred->queries, deferred->query_count * sizeof(*object->queries));
     /* Transfer our references to the queries to the command list. */
 
-    object->data = memory;
-    object->data_size = deferred->data_size;
-    memcpy(object->data, deferred->data, deferred->data_size);
+    /* Transfer the command data itself to the command list. */
+    object->chunks = deferred->chunks;
 
-    deferred->data_size = 0;
+    deferred->chunks = deferred->last_chunk = NULL;
     deferred->resource_count = 0;
     deferred->upload_count = 0;
     deferred->command_list_count = 0;
@@ -4553,6 +4618,7 @@ static void wined3d_command_list_destroy_object(void *object)
         }
     }
 
+    wined3d_cs_chunks_free(list->chunks);
     free(list);
 }
 
@@ -4569,8 +4635,7 @@ ULONG CDECL wined3d_command_list_decref(struct wined3d_command_list *list)
 {
     unsigned int refcount = InterlockedDecrement(&list->refcount);
     struct wined3d_device *device = list->device;
-    const struct wined3d_cs_packet *packet;
-    SIZE_T i, offset;
+    SIZE_T i;
 
     TRACE("%p decreasing refcount to %u.\n", list, refcount);
 
@@ -4585,12 +4650,7 @@ ULONG CDECL wined3d_command_list_decref(struct wined3d_command_list *list)
         for (i = 0; i < list->query_count; ++i)
             wined3d_query_decref(list->queries[i].query);
 
-        offset = 0;
-        while (offset < list->data_size)
-        {
-            packet = wined3d_next_cs_packet(list->data, &offset, ~(SIZE_T)0);
-            wined3d_cs_packet_decref_objects(packet);
-        }
+        wined3d_cs_chunks_decref_objects(list->chunks);
 
         wined3d_mutex_lock();
         wined3d_cs_destroy_object(device->cs, wined3d_command_list_destroy_object, list);
@@ -3422,6 +3422,362 @@ static struct wined3d_adapter *wined3d_adapter_no3d_create(unsigned int ordinal,
     return adapter;
 }
 
+static void adapter_null_get_wined3d_caps(const struct wined3d_adapter *adapter, struct wined3d_caps *caps)
+{
+    caps->ddraw_caps.dds_caps |= WINEDDSCAPS_BACKBUFFER
+            | WINEDDSCAPS_COMPLEX
+            | WINEDDSCAPS_FRONTBUFFER
+            | WINEDDSCAPS_3DDEVICE
+            | WINEDDSCAPS_VIDEOMEMORY
+            | WINEDDSCAPS_OWNDC
+            | WINEDDSCAPS_LOCALVIDMEM
+            | WINEDDSCAPS_NONLOCALVIDMEM;
+    caps->ddraw_caps.caps |= WINEDDCAPS_3D;
+
+    caps->Caps2 |= WINED3DCAPS2_CANGENMIPMAP;
+
+    caps->PrimitiveMiscCaps |= WINED3DPMISCCAPS_BLENDOP
+            | WINED3DPMISCCAPS_INDEPENDENTWRITEMASKS
+            | WINED3DPMISCCAPS_MRTINDEPENDENTBITDEPTHS
+            | WINED3DPMISCCAPS_POSTBLENDSRGBCONVERT
+            | WINED3DPMISCCAPS_SEPARATEALPHABLEND;
+
+    caps->RasterCaps |= WINED3DPRASTERCAPS_MIPMAPLODBIAS
+            | WINED3DPRASTERCAPS_ANISOTROPY;
+
+    caps->TextureFilterCaps |= WINED3DPTFILTERCAPS_MAGFANISOTROPIC
+            | WINED3DPTFILTERCAPS_MINFANISOTROPIC;
+    caps->MaxAnisotropy = 16;
+
+    caps->SrcBlendCaps |= WINED3DPBLENDCAPS_BLENDFACTOR;
+    caps->DestBlendCaps |= WINED3DPBLENDCAPS_BLENDFACTOR
+            | WINED3DPBLENDCAPS_SRCALPHASAT;
+
+    caps->TextureCaps |= WINED3DPTEXTURECAPS_VOLUMEMAP
+            | WINED3DPTEXTURECAPS_MIPVOLUMEMAP
+            | WINED3DPTEXTURECAPS_VOLUMEMAP_POW2
+            | WINED3DPTEXTURECAPS_CUBEMAP
+            | WINED3DPTEXTURECAPS_MIPCUBEMAP
+            | WINED3DPTEXTURECAPS_CUBEMAP_POW2;
+    caps->VolumeTextureFilterCaps |= WINED3DPTFILTERCAPS_MAGFLINEAR
+            | WINED3DPTFILTERCAPS_MAGFPOINT
+            | WINED3DPTFILTERCAPS_MINFLINEAR
+            | WINED3DPTFILTERCAPS_MINFPOINT
+            | WINED3DPTFILTERCAPS_MIPFLINEAR
+            | WINED3DPTFILTERCAPS_MIPFPOINT
+            | WINED3DPTFILTERCAPS_LINEAR
+            | WINED3DPTFILTERCAPS_LINEARMIPLINEAR
+            | WINED3DPTFILTERCAPS_LINEARMIPNEAREST
+            | WINED3DPTFILTERCAPS_MIPLINEAR
+            | WINED3DPTFILTERCAPS_MIPNEAREST
+            | WINED3DPTFILTERCAPS_NEAREST;
+    caps->CubeTextureFilterCaps |= caps->VolumeTextureFilterCaps
+            | WINED3DPTFILTERCAPS_MAGFANISOTROPIC
+            | WINED3DPTFILTERCAPS_MINFANISOTROPIC;
+    caps->VolumeTextureAddressCaps |= WINED3DPTADDRESSCAPS_INDEPENDENTUV
+            | WINED3DPTADDRESSCAPS_CLAMP
+            | WINED3DPTADDRESSCAPS_WRAP
+            | WINED3DPTADDRESSCAPS_BORDER
+            | WINED3DPTADDRESSCAPS_MIRROR
+            | WINED3DPTADDRESSCAPS_MIRRORONCE;
+    caps->TextureAddressCaps |= WINED3DPTADDRESSCAPS_BORDER
+            | WINED3DPTADDRESSCAPS_MIRROR
+            | WINED3DPTADDRESSCAPS_MIRRORONCE;
+
+    caps->MaxVolumeExtent = 2048;
+
+    caps->StencilCaps |= WINED3DSTENCILCAPS_DECR
+            | WINED3DSTENCILCAPS_INCR
+            | WINED3DSTENCILCAPS_TWOSIDED;
+
+    caps->DeclTypes |= WINED3DDTCAPS_FLOAT16_2 | WINED3DDTCAPS_FLOAT16_4;
+
+    caps->MaxPixelShader30InstructionSlots = WINED3DMAX30SHADERINSTRUCTIONS;
+    caps->MaxVertexShader30InstructionSlots = WINED3DMAX30SHADERINSTRUCTIONS;
+    caps->PS20Caps.temp_count = WINED3DPS20_MAX_NUMTEMPS;
+    caps->VS20Caps.temp_count = WINED3DVS20_MAX_NUMTEMPS;
+}
+
+static HRESULT adapter_null_create_shader_resource_view(const struct wined3d_view_desc *desc,
+        struct wined3d_resource *resource, void *parent, const struct wined3d_parent_ops *parent_ops,
+        struct wined3d_shader_resource_view **view)
+{
+    struct wined3d_shader_resource_view *view_null;
+    HRESULT hr;
+
+    TRACE("desc %s, resource %p, parent %p, parent_ops %p, view %p.\n",
+            wined3d_debug_view_desc(desc, resource), resource, parent, parent_ops, view);
+
+    if (!(view_null = calloc(1, sizeof(*view_null))))
+        return E_OUTOFMEMORY;
+
+    if (FAILED(hr = wined3d_shader_resource_view_null_init(view_null, desc, resource, parent, parent_ops)))
+    {
+        WARN("Failed to initialise view, hr %#lx.\n", hr);
+        free(view_null);
+        return hr;
+    }
+
+    TRACE("Created shader resource view %p.\n", view_null);
+    *view = view_null;
+
+    return hr;
+}
+
+static void adapter_null_destroy_shader_resource_view(struct wined3d_shader_resource_view *view)
+{
+    struct wined3d_device *device = view->resource->device;
+    unsigned int swapchain_count = device->swapchain_count;
+
+    TRACE("view %p.\n", view);
+
+    /* See adapter_no3d_destroy_rendertarget_view(). */
+    if (swapchain_count)
+        wined3d_device_incref(device);
+    wined3d_shader_resource_view_cleanup(view);
+    wined3d_cs_destroy_object(device->cs, free, view);
+    if (swapchain_count)
+        wined3d_device_decref(device);
+}
+
+static HRESULT adapter_null_create_unordered_access_view(const struct wined3d_view_desc *desc,
+        struct wined3d_resource *resource, void *parent, const struct wined3d_parent_ops *parent_ops,
+        struct wined3d_unordered_access_view **view)
+{
+    struct wined3d_unordered_access_view *view_null;
+    HRESULT hr;
+
+    TRACE("desc %s, resource %p, parent %p, parent_ops %p, view %p.\n",
+            wined3d_debug_view_desc(desc, resource), resource, parent, parent_ops, view);
+
+    if (!(view_null = calloc(1, sizeof(*view_null))))
+        return E_OUTOFMEMORY;
+
+    if (FAILED(hr = wined3d_unordered_access_view_null_init(view_null, desc, resource, parent, parent_ops)))
+    {
+        WARN("Failed to initialise view, hr %#lx.\n", hr);
+        free(view_null);
+        return hr;
+    }
+
+    TRACE("Created unordered access view %p.\n", view_null);
+    *view = view_null;
+
+    return hr;
+}
+
+static void adapter_null_destroy_unordered_access_view(struct wined3d_unordered_access_view *view)
+{
+    struct wined3d_device *device = view->resource->device;
+    unsigned int swapchain_count = device->swapchain_count;
+
+    TRACE("view %p.\n", view);
+
+    /* See adapter_no3d_destroy_rendertarget_view(). */
+    if (swapchain_count)
+        wined3d_device_incref(device);
+    wined3d_unordered_access_view_cleanup(view);
+    wined3d_cs_destroy_object(device->cs, free, view);
+    if (swapchain_count)
+        wined3d_device_decref(device);
+}
+
+static HRESULT adapter_null_create_sampler(struct wined3d_device *device, const struct wined3d_sampler_desc *desc,
+        void *parent, const struct wined3d_parent_ops *parent_ops, struct wined3d_sampler **sampler)
+{
+    struct wined3d_sampler *sampler_null;
+
+    TRACE("device %p, desc %p, parent %p, parent_ops %p, sampler %p.\n",
+            device, desc, parent, parent_ops, sampler);
+
+    if (!(sampler_null = calloc(1, sizeof(*sampler_null))))
+        return E_OUTOFMEMORY;
+
+    wined3d_sampler_null_init(sampler_null, device, desc, parent, parent_ops);
+
+    TRACE("Created sampler %p.\n", sampler_null);
+    *sampler = sampler_null;
+
+    return WINED3D_OK;
+}
+
+static void adapter_null_destroy_sampler(struct wined3d_sampler *sampler)
+{
+    TRACE("sampler %p.\n", sampler);
+
+    wined3d_cs_destroy_object(sampler->device->cs, free, sampler);
+}
+
+static HRESULT adapter_null_create_query(struct wined3d_device *device, enum wined3d_query_type type,
+        void *parent, const struct wined3d_parent_ops *parent_ops, struct wined3d_query **query)
+{
+    TRACE("device %p, type %#x, parent %p, parent_ops %p, query %p.\n",
+            device, type, parent, parent_ops, query);
+
+    return wined3d_query_null_create(device, type, parent, parent_ops, query);
+}
+
+static void adapter_null_destroy_query(struct wined3d_query *query)
+{
+    TRACE("query %p.\n", query);
+
+    wined3d_cs_destroy_object(query->device->cs, free, query);
+}
+
+static void adapter_null_draw_primitive(struct wined3d_device *device,
+        const struct wined3d_state *state, const struct wined3d_draw_parameters *parameters)
+{
+    TRACE("device %p, state %p, parameters %p.\n", device, state, parameters);
+}
+
+static void adapter_null_dispatch_compute(struct wined3d_device *device,
+        const struct wined3d_state *state, const struct wined3d_dispatch_parameters *parameters)
+{
+    TRACE("device %p, state %p, parameters %p.\n", device, state, parameters);
+}
+
+static void adapter_null_clear_uav(struct wined3d_context *context,
+        struct wined3d_unordered_access_view *view, const struct wined3d_uvec4 *clear_value, bool fp)
+{
+    TRACE("context %p, view %p, clear_value %s, fp %#x.\n", context, view, debug_uvec4(clear_value), fp);
+}
+
+/* The null renderer runs the complete front end (state tracking, the command
+ * stream, resource and view management) but never submits anything to a
+ * graphics API. This makes it useful for measuring wined3d's own CPU
+ * overhead, and for running applications that don't need visible output. */
+static const struct wined3d_adapter_ops wined3d_adapter_null_ops =
+{
+    .adapter_destroy = adapter_no3d_destroy,
+    .adapter_create_device = adapter_no3d_create_device,
+    .adapter_destroy_device = adapter_no3d_destroy_device,
+    .adapter_acquire_context = adapter_no3d_acquire_context,
+    .adapter_release_context = adapter_no3d_release_context,
+    .adapter_get_wined3d_caps = adapter_null_get_wined3d_caps,
+    .adapter_check_format = adapter_no3d_check_format,
+    .adapter_init_3d = adapter_no3d_init_3d,
+    .adapter_uninit_3d = adapter_no3d_uninit_3d,
+    .adapter_map_bo_address = adapter_no3d_map_bo_address,
+    .adapter_unmap_bo_address = adapter_no3d_unmap_bo_address,
+    .adapter_copy_bo_address = adapter_no3d_copy_bo_address,
+    .adapter_flush_bo_address = adapter_no3d_flush_bo_address,
+    .adapter_alloc_bo = adapter_no3d_alloc_bo,
+    .adapter_destroy_bo = adapter_no3d_destroy_bo,
+    .adapter_create_swapchain = adapter_no3d_create_swapchain,
+    .adapter_destroy_swapchain = adapter_no3d_destroy_swapchain,
+    .adapter_create_buffer = adapter_no3d_create_buffer,
+    .adapter_destroy_buffer = adapter_no3d_destroy_buffer,
+    .adapter_create_texture = adapter_no3d_create_texture,
+    .adapter_destroy_texture = adapter_no3d_destroy_texture,
+    .adapter_create_rendertarget_view = adapter_no3d_create_rendertarget_view,
+    .adapter_destroy_rendertarget_view = adapter_no3d_destroy_rendertarget_view,
+    .adapter_create_shader_resource_view = adapter_null_create_shader_resource_view,
+    .adapter_destroy_shader_resource_view = adapter_null_destroy_shader_resource_view,
+    .adapter_create_unordered_access_view = adapter_null_create_unordered_access_view,
+    .adapter_destroy_unordered_access_view = adapter_null_destroy_unordered_access_view,
+    .adapter_create_sampler = adapter_null_create_sampler,
+    .adapter_destroy_sampler = adapter_null_destroy_sampler,
+    .adapter_create_query = adapter_null_create_query,
+    .adapter_destroy_query = adapter_null_destroy_query,
+    .adapter_flush_context = adapter_no3d_flush_context,
+    .adapter_draw_primitive = adapter_null_draw_primitive,
+    .adapter_dispatch_compute = adapter_null_dispatch_compute,
+    .adapter_clear_uav = adapter_null_clear_uav,
+};
+
+static void wined3d_adapter_null_init_d3d_info(struct wined3d_adapter *adapter, unsigned int wined3d_creation_flags)
+{
+    struct wined3d_d3d_info *d3d_info = &adapter->d3d_info;
+    struct wined3d_vertex_caps vertex_caps;
+    struct shader_caps shader_caps;
+
+    adapter->shader_backend->shader_get_caps(adapter, &shader_caps);
+    adapter->vertex_pipe->vp_get_caps(adapter, &vertex_caps);
+    adapter->fragment_pipe->get_caps(adapter, &d3d_info->ffp_fragment_caps);
+
+    d3d_info->limits.vs_version = shader_caps.vs_version;
+    d3d_info->limits.hs_version = shader_caps.hs_version;
+    d3d_info->limits.ds_version = shader_caps.ds_version;
+    d3d_info->limits.gs_version = shader_caps.gs_version;
+    d3d_info->limits.ps_version = shader_caps.ps_version;
+    d3d_info->limits.cs_version = shader_caps.cs_version;
+    d3d_info->limits.vs_uniform_count = shader_caps.vs_uniform_count;
+    d3d_info->limits.ps_uniform_count = shader_caps.ps_uniform_count;
+    d3d_info->limits.varying_count = shader_caps.varying_count;
+    d3d_info->limits.ffp_vertex_blend_matrices = vertex_caps.max_vertex_blend_matrices;
+    d3d_info->limits.active_light_count = vertex_caps.max_active_lights;
+
+    d3d_info->limits.max_rt_count = WINED3D_MAX_RENDER_TARGETS;
+    d3d_info->limits.max_clip_distances = WINED3D_MAX_CLIP_DISTANCES;
+    d3d_info->limits.texture_size = 16384;
+    d3d_info->limits.pointsize_max = 1024.0f;
+    d3d_info->limits.sample_count = 8;
+
+    d3d_info->wined3d_creation_flags = wined3d_creation_flags;
+
+    d3d_info->unconditional_npot = true;
+    d3d_info->draw_base_vertex_offset = true;
+    d3d_info->vertex_bgra = true;
+    d3d_info->texture_swizzle = true;
+    d3d_info->clip_control = true;
+    d3d_info->full_ffp_varyings = true;
+    d3d_info->multithread_safe = true;
+    d3d_info->subpixel_viewport = true;
+    d3d_info->feature_level = WINED3D_FEATURE_LEVEL_11_1;
+}
+
+static struct wined3d_adapter *wined3d_adapter_null_create(unsigned int ordinal, unsigned int wined3d_creation_flags)
+{
+    struct wined3d_adapter *adapter;
+    LUID primary_luid, *luid = NULL;
+
+    static const struct wined3d_gpu_description gpu_description =
+    {
+        HW_VENDOR_SOFTWARE, CARD_WINE, "WineD3D Null Renderer", DRIVER_WINE, 1024,
+    };
+
+    TRACE("ordinal %u, wined3d_creation_flags %#x.\n", ordinal, wined3d_creation_flags);
+
+    if (!(adapter = calloc(1, sizeof(*adapter))))
+        return NULL;
+
+    if (ordinal == 0 && wined3d_get_primary_adapter_luid(&primary_luid))
+        luid = &primary_luid;
+
+    if (!wined3d_adapter_init(adapter, ordinal, luid, &wined3d_adapter_null_ops))
+    {
+        free(adapter);
+        return NULL;
+    }
+
+    if (!wined3d_adapter_null_init_format_info(adapter))
+    {
+        wined3d_adapter_cleanup(adapter);
+        free(adapter);
+        return NULL;
+    }
+
+    if (!wined3d_driver_info_init(&adapter->driver_info, &gpu_description, WINED3D_FEATURE_LEVEL_11_1, 0, 0))
+    {
+        wined3d_adapter_cleanup(adapter);
+        free(adapter);
+        return NULL;
+    }
+    adapter->vram_bytes_used = 0;
+    TRACE("Emulating 0x%s bytes of video ram.\n", wine_dbgstr_longlong(adapter->driver_info.vram_bytes));
+
+    adapter->vertex_pipe = &none_vertex_pipe;
+    adapter->fragment_pipe = &none_fragment_pipe;
+    adapter->misc_state_template = misc_state_template_no3d;
+    adapter->shader_backend = &null_shader_backend;
+
+    wined3d_adapter_null_init_d3d_info(adapter, wined3d_creation_flags);
+
+    TRACE("Created adapter %p.\n", adapter);
+
+    return adapter;
+}
+
 static BOOL wined3d_adapter_create_output(struct wined3d_adapter *adapter, const WCHAR *output_name)
 {
     HRESULT hr;
@@ -3523,6 +3879,9 @@ static struct wined3d_adapter *wined3d_adapter_create(unsigned int ordinal, DWOR
     if (wined3d_creation_flags & WINED3D_NO3D)
         return wined3d_adapter_no3d_create(ordinal, wined3d_creation_flags);
 
+    if (wined3d_settings.renderer == WINED3D_RENDERER_NULL)
+        return wined3d_adapter_null_create(ordinal, wined3d_creation_flags);
+
     if (wined3d_settings.renderer == WINED3D_RENDERER_VULKAN)
         return wined3d_adapter_vk_create(ordinal, wined3d_creation_flags);
 
@@ -862,7 +862,7 @@ static bool compile_hlsl_shader(const struct wined3d_string_buffer *hlsl,
     compile_info.next = &hlsl_source_info;
     hlsl_source_info.profile = profile;
 
-    ret = vkd3d_shader_compile(&compile_info, sm1, &messages);
+    ret = wined3d_shader_compile(&compile_info, sm1, &messages);
     if (messages && *messages && FIXME_ON(d3d_shader))
     {
         const char *ptr, *end, *line;
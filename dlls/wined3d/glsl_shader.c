@@ -787,7 +787,7 @@ static GLuint shader_glsl_generate_vkd3d_shader(const struct wined3d_context_gl
     info.log_level = VKD3D_SHADER_LOG_WARNING;
     info.source_name = NULL;
 
-    ret = vkd3d_shader_compile(&info, &glsl, &messages);
+    ret = wined3d_shader_compile(&info, &glsl, &messages);
     if (messages && *messages && FIXME_ON(d3d_shader))
     {
         const char *ptr, *end, *line;
@@ -814,7 +814,7 @@ static GLuint shader_glsl_generate_vkd3d_shader(const struct wined3d_context_gl
     if (!(shader_id = GL_EXTCALL(glCreateShader(gl_shader_type))))
     {
         ERR("Failed to create shader.\n");
-        vkd3d_shader_free_shader_code(&glsl);
+        free((void *)glsl.code);
         return 0;
     }
 
@@ -825,7 +825,7 @@ static GLuint shader_glsl_generate_vkd3d_shader(const struct wined3d_context_gl
     checkGLcall("glCompileShader");
     print_glsl_info_log(gl_info, shader_id, FALSE);
 
-    vkd3d_shader_free_shader_code(&glsl);
+    free((void *)glsl.code);
 
     return shader_id;
 }
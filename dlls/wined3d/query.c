@@ -1985,6 +1985,94 @@ HRESULT wined3d_query_vk_create(struct wined3d_device *device, enum wined3d_quer
     return WINED3D_OK;
 }
 
+/* Queries for adapters without a GPU. Nothing is ever drawn, so every query
+ * completes as soon as it's issued, with zero results. */
+static BOOL wined3d_query_null_poll(struct wined3d_query *query, uint32_t flags)
+{
+    if (query->type == WINED3D_QUERY_TYPE_EVENT)
+        *(BOOL *)query->data = TRUE;
+    return TRUE;
+}
+
+static BOOL wined3d_query_null_issue(struct wined3d_query *query, uint32_t flags)
+{
+    return FALSE;
+}
+
+static void wined3d_query_null_destroy(struct wined3d_query *query)
+{
+    free(query);
+}
+
+static const struct wined3d_query_ops wined3d_query_null_ops =
+{
+    .query_poll = wined3d_query_null_poll,
+    .query_issue = wined3d_query_null_issue,
+    .query_destroy = wined3d_query_null_destroy,
+};
+
+HRESULT wined3d_query_null_create(struct wined3d_device *device, enum wined3d_query_type type,
+        void *parent, const struct wined3d_parent_ops *parent_ops, struct wined3d_query **query)
+{
+    struct wined3d_query_data_timestamp_disjoint *disjoint_data;
+    struct wined3d_query *query_null;
+    unsigned int data_size;
+
+    TRACE("device %p, type %#x, parent %p, parent_ops %p, query %p.\n",
+            device, type, parent, parent_ops, query);
+
+    switch (type)
+    {
+        case WINED3D_QUERY_TYPE_EVENT:
+            data_size = sizeof(BOOL);
+            break;
+
+        case WINED3D_QUERY_TYPE_OCCLUSION:
+        case WINED3D_QUERY_TYPE_TIMESTAMP:
+            data_size = sizeof(uint64_t);
+            break;
+
+        case WINED3D_QUERY_TYPE_TIMESTAMP_DISJOINT:
+            data_size = sizeof(struct wined3d_query_data_timestamp_disjoint);
+            break;
+
+        case WINED3D_QUERY_TYPE_PIPELINE_STATISTICS:
+            data_size = sizeof(struct wined3d_query_data_pipeline_statistics);
+            break;
+
+        case WINED3D_QUERY_TYPE_SO_STATISTICS:
+        case WINED3D_QUERY_TYPE_SO_STATISTICS_STREAM0:
+        case WINED3D_QUERY_TYPE_SO_STATISTICS_STREAM1:
+        case WINED3D_QUERY_TYPE_SO_STATISTICS_STREAM2:
+        case WINED3D_QUERY_TYPE_SO_STATISTICS_STREAM3:
+            data_size = sizeof(struct wined3d_query_data_so_statistics);
+            break;
+
+        default:
+            FIXME("Unhandled query type %#x.\n", type);
+            return WINED3DERR_NOTAVAILABLE;
+    }
+
+    if (!(query_null = calloc(1, sizeof(*query_null) + data_size)))
+        return E_OUTOFMEMORY;
+
+    wined3d_query_init(query_null, device, type, query_null + 1, data_size,
+            &wined3d_query_null_ops, parent, parent_ops);
+    query_null->poll_in_cs = false;
+
+    if (type == WINED3D_QUERY_TYPE_TIMESTAMP_DISJOINT)
+    {
+        disjoint_data = (struct wined3d_query_data_timestamp_disjoint *)(query_null + 1);
+        disjoint_data->frequency = 1000000000;
+        disjoint_data->disjoint = FALSE;
+    }
+
+    TRACE("Created query %p.\n", query_null);
+    *query = query_null;
+
+    return WINED3D_OK;
+}
+
 HRESULT CDECL wined3d_query_create(struct wined3d_device *device, enum wined3d_query_type type,
         void *parent, const struct wined3d_parent_ops *parent_ops, struct wined3d_query **query)
 {
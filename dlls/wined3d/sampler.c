@@ -127,6 +127,15 @@ static void wined3d_sampler_gl_cs_init(void *object)
     context_release(context);
 }
 
+void wined3d_sampler_null_init(struct wined3d_sampler *sampler_null, struct wined3d_device *device,
+        const struct wined3d_sampler_desc *desc, void *parent, const struct wined3d_parent_ops *parent_ops)
+{
+    TRACE("sampler_null %p, device %p, desc %p, parent %p, parent_ops %p.\n",
+            sampler_null, device, desc, parent, parent_ops);
+
+    wined3d_sampler_init(sampler_null, device, desc, parent, parent_ops);
+}
+
 void wined3d_sampler_gl_init(struct wined3d_sampler_gl *sampler_gl, struct wined3d_device *device,
         const struct wined3d_sampler_desc *desc, void *parent, const struct wined3d_parent_ops *parent_ops)
 {
@@ -2081,6 +2081,49 @@ const struct wined3d_shader_backend_ops none_shader_backend =
     shader_none_shader_compile,
 };
 
+static void shader_null_get_caps(const struct wined3d_adapter *adapter, struct shader_caps *caps)
+{
+    /* Shaders are never translated, so we can claim anything the front end
+     * is able to parse. */
+    memset(caps, 0, sizeof(*caps));
+
+    caps->vs_version = min(wined3d_settings.max_sm_vs, 5);
+    caps->hs_version = min(wined3d_settings.max_sm_hs, 5);
+    caps->ds_version = min(wined3d_settings.max_sm_ds, 5);
+    caps->gs_version = min(wined3d_settings.max_sm_gs, 5);
+    caps->ps_version = min(wined3d_settings.max_sm_ps, 5);
+    caps->cs_version = min(wined3d_settings.max_sm_cs, 5);
+
+    caps->vs_uniform_count = WINED3D_MAX_VS_CONSTS_F;
+    caps->ps_uniform_count = WINED3D_MAX_PS_CONSTS_F;
+    caps->ps_1x_max_value = FLT_MAX;
+    caps->varying_count = 0;
+    caps->wined3d_caps = WINED3D_SHADER_CAP_FULL_FFP_VARYINGS;
+}
+
+/* The shader backend of the null adapter. It behaves like the "none"
+ * backend, but reports shader model 5 support so that applications take
+ * their usual rendering paths. */
+const struct wined3d_shader_backend_ops null_shader_backend =
+{
+    shader_none_handle_instruction,
+    shader_none_precompile,
+    shader_none_apply_draw_state,
+    shader_none_apply_compute_state,
+    shader_none_disable,
+    shader_none_update_float_vertex_constants,
+    shader_none_update_float_pixel_constants,
+    shader_none_destroy,
+    shader_none_alloc,
+    shader_none_free,
+    shader_none_allocate_context_data,
+    shader_none_free_context_data,
+    shader_none_init_context_state,
+    shader_null_get_caps,
+    shader_none_color_fixup_supported,
+    shader_none_shader_compile,
+};
+
 static unsigned int shader_max_version_from_feature_level(enum wined3d_feature_level level)
 {
     switch (level)
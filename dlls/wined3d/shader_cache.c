@@ -0,0 +1,721 @@
+/*
+ * Persistent cache of translated shaders
+ *
+ * Copyright (C) the Wine project
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+
+/* The results of vkd3d_shader_compile() are stored in a directory, one file
+ * per entry. The file name is derived from a hash of all the compilation
+ * inputs, and the inputs themselves are stored in the file as well, so that
+ * hash collisions are detected. Entries are written to a temporary file and
+ * then renamed, which makes it safe for several processes to share the same
+ * directory. The last write time of an entry is updated every time it is
+ * used, and the least recently used entries are removed when the size of the
+ * directory exceeds the configured limit. */
+
+#include "wined3d_private.h"
+
+WINE_DEFAULT_DEBUG_CHANNEL(d3d_shader);
+WINE_DECLARE_DEBUG_CHANNEL(d3d_perf);
+
+#define WINED3D_SHADER_CACHE_MAGIC 0x43533357 /* "W3SC" */
+/* Increase when the file format or the key layout changes. */
+#define WINED3D_SHADER_CACHE_VERSION 1
+#define WINED3D_SHADER_CACHE_NAME_LENGTH 24
+
+struct wined3d_shader_cache_header
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t key_size;
+    uint32_t data_size;
+};
+
+struct wined3d_shader_cache_key
+{
+    uint8_t *data;
+    SIZE_T size;
+    SIZE_T capacity;
+    bool valid;
+};
+
+struct wined3d_shader_cache_file
+{
+    FILETIME time;
+    uint64_t size;
+    WCHAR name[WINED3D_SHADER_CACHE_NAME_LENGTH + 5];
+};
+
+/* Common header of the structures chained from vkd3d_shader_compile_info. */
+struct wined3d_shader_cache_chain
+{
+    enum vkd3d_shader_structure_type type;
+    const void *next;
+};
+
+static struct
+{
+    bool initialised;
+    WCHAR *path;
+    SIZE_T path_len;
+    uint64_t max_size;
+    uint64_t size;
+    bool trimming;
+
+    unsigned int hits;
+    unsigned int misses;
+    uint64_t bytes_read;
+    uint64_t bytes_written;
+} shader_cache;
+
+static CRITICAL_SECTION shader_cache_cs;
+static CRITICAL_SECTION_DEBUG shader_cache_cs_debug =
+{
+    0, 0, &shader_cache_cs,
+    {&shader_cache_cs_debug.ProcessLocksList,
+    &shader_cache_cs_debug.ProcessLocksList},
+    0, 0, {(DWORD_PTR)(__FILE__ ": shader_cache_cs")}
+};
+static CRITICAL_SECTION shader_cache_cs = {&shader_cache_cs_debug, -1, 0, 0, 0, 0};
+
+static void shader_cache_key_add(struct wined3d_shader_cache_key *key, const void *data, SIZE_T size)
+{
+    if (!key->valid)
+        return;
+
+    if (!wined3d_array_reserve((void **)&key->data, &key->capacity, key->size + size, 1))
+    {
+        key->valid = false;
+        return;
+    }
+    memcpy(key->data + key->size, data, size);
+    key->size += size;
+}
+
+static void shader_cache_key_add_uint(struct wined3d_shader_cache_key *key, uint32_t value)
+{
+    shader_cache_key_add(key, &value, sizeof(value));
+}
+
+static void shader_cache_key_add_string(struct wined3d_shader_cache_key *key, const char *str)
+{
+    SIZE_T len = str ? strlen(str) + 1 : 0;
+
+    shader_cache_key_add_uint(key, len);
+    shader_cache_key_add(key, str, len);
+}
+
+static void shader_cache_key_add_code(struct wined3d_shader_cache_key *key, const struct vkd3d_shader_code *code)
+{
+    uint64_t size = code->size;
+
+    shader_cache_key_add(key, &size, sizeof(size));
+    shader_cache_key_add(key, code->code, code->size);
+}
+
+static void shader_cache_key_add_descriptor_binding(struct wined3d_shader_cache_key *key,
+        const struct vkd3d_shader_descriptor_binding *binding)
+{
+    shader_cache_key_add_uint(key, binding->set);
+    shader_cache_key_add_uint(key, binding->binding);
+    shader_cache_key_add_uint(key, binding->count);
+}
+
+static void shader_cache_key_add_interface_info(struct wined3d_shader_cache_key *key,
+        const struct vkd3d_shader_interface_info *info)
+{
+    unsigned int i;
+
+    shader_cache_key_add_uint(key, info->binding_count);
+    for (i = 0; i < info->binding_count; ++i)
+    {
+        const struct vkd3d_shader_resource_binding *b = &info->bindings[i];
+
+        shader_cache_key_add_uint(key, b->type);
+        shader_cache_key_add_uint(key, b->register_space);
+        shader_cache_key_add_uint(key, b->register_index);
+        shader_cache_key_add_uint(key, b->shader_visibility);
+        shader_cache_key_add_uint(key, b->flags);
+        shader_cache_key_add_descriptor_binding(key, &b->binding);
+    }
+
+    shader_cache_key_add_uint(key, info->push_constant_buffer_count);
+    for (i = 0; i < info->push_constant_buffer_count; ++i)
+    {
+        const struct vkd3d_shader_push_constant_buffer *p = &info->push_constant_buffers[i];
+
+        shader_cache_key_add_uint(key, p->register_space);
+        shader_cache_key_add_uint(key, p->register_index);
+        shader_cache_key_add_uint(key, p->shader_visibility);
+        shader_cache_key_add_uint(key, p->offset);
+        shader_cache_key_add_uint(key, p->size);
+    }
+
+    shader_cache_key_add_uint(key, info->combined_sampler_count);
+    for (i = 0; i < info->combined_sampler_count; ++i)
+    {
+        const struct vkd3d_shader_combined_resource_sampler *s = &info->combined_samplers[i];
+
+        shader_cache_key_add_uint(key, s->resource_space);
+        shader_cache_key_add_uint(key, s->resource_index);
+        shader_cache_key_add_uint(key, s->sampler_space);
+        shader_cache_key_add_uint(key, s->sampler_index);
+        shader_cache_key_add_uint(key, s->shader_visibility);
+        shader_cache_key_add_uint(key, s->flags);
+        shader_cache_key_add_descriptor_binding(key, &s->binding);
+    }
+
+    shader_cache_key_add_uint(key, info->uav_counter_count);
+    for (i = 0; i < info->uav_counter_count; ++i)
+    {
+        const struct vkd3d_shader_uav_counter_binding *u = &info->uav_counters[i];
+
+        shader_cache_key_add_uint(key, u->register_space);
+        shader_cache_key_add_uint(key, u->register_index);
+        shader_cache_key_add_uint(key, u->shader_visibility);
+        shader_cache_key_add_descriptor_binding(key, &u->binding);
+        shader_cache_key_add_uint(key, u->offset);
+    }
+}
+
+static void shader_cache_key_add_transform_feedback_info(struct wined3d_shader_cache_key *key,
+        const struct vkd3d_shader_transform_feedback_info *info)
+{
+    unsigned int i;
+
+    shader_cache_key_add_uint(key, info->element_count);
+    for (i = 0; i < info->element_count; ++i)
+    {
+        const struct vkd3d_shader_transform_feedback_element *e = &info->elements[i];
+
+        shader_cache_key_add_uint(key, e->stream_index);
+        shader_cache_key_add_string(key, e->semantic_name);
+        shader_cache_key_add_uint(key, e->semantic_index);
+        shader_cache_key_add_uint(key, e->component_index);
+        shader_cache_key_add_uint(key, e->component_count);
+        shader_cache_key_add_uint(key, e->output_slot);
+    }
+
+    shader_cache_key_add_uint(key, info->buffer_stride_count);
+    for (i = 0; i < info->buffer_stride_count; ++i)
+        shader_cache_key_add_uint(key, info->buffer_strides[i]);
+}
+
+static bool shader_cache_key_add_spirv_target_info(struct wined3d_shader_cache_key *key,
+        const struct vkd3d_shader_spirv_target_info *info)
+{
+    unsigned int i;
+
+    shader_cache_key_add_string(key, info->entry_point);
+    shader_cache_key_add_uint(key, info->environment);
+
+    shader_cache_key_add_uint(key, info->extension_count);
+    for (i = 0; i < info->extension_count; ++i)
+        shader_cache_key_add_uint(key, info->extensions[i]);
+
+    shader_cache_key_add_uint(key, info->parameter_count);
+    for (i = 0; i < info->parameter_count; ++i)
+    {
+        const struct vkd3d_shader_parameter *p = &info->parameters[i];
+
+        shader_cache_key_add_uint(key, p->name);
+        shader_cache_key_add_uint(key, p->type);
+        shader_cache_key_add_uint(key, p->data_type);
+        if (p->type == VKD3D_SHADER_PARAMETER_TYPE_IMMEDIATE_CONSTANT)
+            shader_cache_key_add_uint(key, p->u.immediate_constant.u.u32);
+        else if (p->type == VKD3D_SHADER_PARAMETER_TYPE_SPECIALIZATION_CONSTANT)
+            shader_cache_key_add_uint(key, p->u.specialization_constant.id);
+        else
+            return false;
+    }
+
+    shader_cache_key_add_uint(key, info->dual_source_blending);
+    shader_cache_key_add_uint(key, info->output_swizzle_count);
+    for (i = 0; i < info->output_swizzle_count; ++i)
+        shader_cache_key_add_uint(key, info->output_swizzles[i]);
+
+    return true;
+}
+
+static void shader_cache_key_add_varying_map_info(struct wined3d_shader_cache_key *key,
+        const struct vkd3d_shader_varying_map_info *info)
+{
+    unsigned int i;
+
+    shader_cache_key_add_uint(key, info->varying_count);
+    for (i = 0; i < info->varying_count; ++i)
+    {
+        shader_cache_key_add_uint(key, info->varying_map[i].output_signature_index);
+        shader_cache_key_add_uint(key, info->varying_map[i].input_register_index);
+        shader_cache_key_add_uint(key, info->varying_map[i].input_mask);
+    }
+}
+
+static void shader_cache_key_add_hlsl_source_info(struct wined3d_shader_cache_key *key,
+        const struct vkd3d_shader_hlsl_source_info *info)
+{
+    shader_cache_key_add_string(key, info->entry_point);
+    shader_cache_key_add_code(key, &info->secondary_code);
+    shader_cache_key_add_string(key, info->profile);
+}
+
+/* Serialise everything the output of vkd3d_shader_compile() depends on. */
+static bool shader_cache_key_init(struct wined3d_shader_cache_key *key, const struct vkd3d_shader_compile_info *info)
+{
+    const struct wined3d_shader_cache_chain *chain;
+    unsigned int i;
+
+    memset(key, 0, sizeof(*key));
+    key->valid = true;
+
+    shader_cache_key_add_uint(key, WINED3D_SHADER_CACHE_VERSION);
+    shader_cache_key_add_string(key, vkd3d_shader_get_version(NULL, NULL));
+
+    shader_cache_key_add_code(key, &info->source);
+    shader_cache_key_add_uint(key, info->source_type);
+    shader_cache_key_add_uint(key, info->target_type);
+    shader_cache_key_add_uint(key, info->option_count);
+    for (i = 0; i < info->option_count; ++i)
+    {
+        shader_cache_key_add_uint(key, info->options[i].name);
+        shader_cache_key_add_uint(key, info->options[i].value);
+    }
+
+    for (chain = info->next; chain; chain = chain->next)
+    {
+        shader_cache_key_add_uint(key, chain->type);
+        switch (chain->type)
+        {
+            case VKD3D_SHADER_STRUCTURE_TYPE_INTERFACE_INFO:
+                shader_cache_key_add_interface_info(key, (const struct vkd3d_shader_interface_info *)chain);
+                break;
+
+            case VKD3D_SHADER_STRUCTURE_TYPE_TRANSFORM_FEEDBACK_INFO:
+                shader_cache_key_add_transform_feedback_info(key,
+                        (const struct vkd3d_shader_transform_feedback_info *)chain);
+                break;
+
+            case VKD3D_SHADER_STRUCTURE_TYPE_SPIRV_TARGET_INFO:
+                if (!shader_cache_key_add_spirv_target_info(key,
+                        (const struct vkd3d_shader_spirv_target_info *)chain))
+                    key->valid = false;
+                break;
+
+            case VKD3D_SHADER_STRUCTURE_TYPE_VARYING_MAP_INFO:
+                shader_cache_key_add_varying_map_info(key, (const struct vkd3d_shader_varying_map_info *)chain);
+                break;
+
+            case VKD3D_SHADER_STRUCTURE_TYPE_HLSL_SOURCE_INFO:
+                shader_cache_key_add_hlsl_source_info(key, (const struct vkd3d_shader_hlsl_source_info *)chain);
+                break;
+
+            default:
+                TRACE("Not caching shader with structure type %#x.\n", chain->type);
+                key->valid = false;
+                break;
+        }
+        if (!key->valid)
+            break;
+    }
+
+    if (!key->valid || key->size > UINT32_MAX)
+    {
+        free(key->data);
+        return false;
+    }
+    return true;
+}
+
+static void shader_cache_format_hex(WCHAR *dst, uint64_t value, unsigned int digits)
+{
+    static const WCHAR hex[] = L"0123456789abcdef";
+
+    while (digits--)
+    {
+        dst[digits] = hex[value & 0xf];
+        value >>= 4;
+    }
+}
+
+/* Build the path of the entry for "key", followed by "suffix". */
+static WCHAR *shader_cache_get_filename(const struct wined3d_shader_cache_key *key, const WCHAR *suffix)
+{
+    uint64_t hash = 0xcbf29ce484222325ull;
+    WCHAR *filename, *name;
+    SIZE_T i;
+
+    /* 64-bit FNV-1a */
+    for (i = 0; i < key->size; ++i)
+    {
+        hash ^= key->data[i];
+        hash *= 0x100000001b3ull;
+    }
+
+    if (!(filename = malloc((shader_cache.path_len + WINED3D_SHADER_CACHE_NAME_LENGTH
+            + wcslen(suffix) + 1) * sizeof(*filename))))
+        return NULL;
+
+    memcpy(filename, shader_cache.path, shader_cache.path_len * sizeof(*filename));
+    name = filename + shader_cache.path_len;
+    shader_cache_format_hex(name, hash, 16);
+    shader_cache_format_hex(name + 16, key->size, 8);
+    wcscpy(name + WINED3D_SHADER_CACHE_NAME_LENGTH, suffix);
+
+    return filename;
+}
+
+static int __cdecl shader_cache_file_compare(const void *a, const void *b)
+{
+    const struct wined3d_shader_cache_file *file_a = a, *file_b = b;
+
+    return CompareFileTime(&file_a->time, &file_b->time);
+}
+
+/* Remove the least recently used entries until the size of the cache is at
+ * most "max_size". Returns the resulting size of the cache, or "size" if it
+ * couldn't be determined. */
+static uint64_t shader_cache_trim(uint64_t max_size, uint64_t size)
+{
+    struct wined3d_shader_cache_file *files = NULL;
+    SIZE_T files_size = 0, count = 0, i;
+    WIN32_FIND_DATAW data;
+    WCHAR *filename;
+    HANDLE handle;
+
+    if (!(filename = malloc((shader_cache.path_len + ARRAY_SIZE(files->name)) * sizeof(*filename))))
+        return size;
+    memcpy(filename, shader_cache.path, shader_cache.path_len * sizeof(*filename));
+    wcscpy(filename + shader_cache.path_len, L"*.bin");
+    size = 0;
+
+    if ((handle = FindFirstFileW(filename, &data)) != INVALID_HANDLE_VALUE)
+    {
+        do
+        {
+            if (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+                continue;
+            if (wcslen(data.cFileName) >= ARRAY_SIZE(files->name))
+                continue;
+            if (!wined3d_array_reserve((void **)&files, &files_size, count + 1, sizeof(*files)))
+                break;
+            files[count].time = data.ftLastWriteTime;
+            files[count].size = ((uint64_t)data.nFileSizeHigh << 32) | data.nFileSizeLow;
+            wcscpy(files[count].name, data.cFileName);
+            size += files[count].size;
+            ++count;
+        } while (FindNextFileW(handle, &data));
+        FindClose(handle);
+    }
+
+    if (size > max_size)
+    {
+        qsort(files, count, sizeof(*files), shader_cache_file_compare);
+        for (i = 0; i < count && size > max_size; ++i)
+        {
+            wcscpy(filename + shader_cache.path_len, files[i].name);
+            /* Another process may have removed or replaced it already. */
+            if (DeleteFileW(filename))
+                size -= files[i].size;
+        }
+        TRACE("Trimmed shader cache to %s bytes.\n", wine_dbgstr_longlong(size));
+    }
+
+    free(files);
+    free(filename);
+    return size;
+}
+
+static bool shader_cache_create_directory(WCHAR *path)
+{
+    WCHAR *p;
+
+    for (p = path; *p; ++p)
+    {
+        if ((*p != '\\' && *p != '/') || p == path || p[-1] == ':' || p[-1] == '\\')
+            continue;
+        *p = 0;
+        CreateDirectoryW(path, NULL);
+        *p = '\\';
+    }
+
+    return CreateDirectoryW(path, NULL) || GetLastError() == ERROR_ALREADY_EXISTS;
+}
+
+/* Called with shader_cache_cs held. */
+static bool shader_cache_init(void)
+{
+    static const WCHAR default_dir[] = L"\\wine\\wined3d_shader_cache";
+    WCHAR *path;
+    DWORD len;
+
+    if (shader_cache.initialised)
+        return !!shader_cache.path;
+    shader_cache.initialised = true;
+
+    if (!wined3d_settings.shader_cache_size)
+        return false;
+
+    if (wined3d_settings.shader_cache_path)
+    {
+        len = MultiByteToWideChar(CP_ACP, 0, wined3d_settings.shader_cache_path, -1, NULL, 0);
+        if (!len || !(path = malloc((len + 1) * sizeof(*path))))
+            return false;
+        MultiByteToWideChar(CP_ACP, 0, wined3d_settings.shader_cache_path, -1, path, len);
+        --len;
+    }
+    else
+    {
+        if (!(len = GetEnvironmentVariableW(L"LOCALAPPDATA", NULL, 0)))
+        {
+            WARN("LOCALAPPDATA is not set, disabling the shader cache.\n");
+            return false;
+        }
+        if (!(path = malloc((len + ARRAY_SIZE(default_dir)) * sizeof(*path))))
+            return false;
+        len = GetEnvironmentVariableW(L"LOCALAPPDATA", path, len);
+        wcscpy(path + len, default_dir);
+        len += ARRAY_SIZE(default_dir) - 1;
+    }
+
+    while (len && (path[len - 1] == '\\' || path[len - 1] == '/'))
+        path[--len] = 0;
+
+    if (!shader_cache_create_directory(path))
+    {
+        ERR("Failed to create shader cache directory %s, error %lu.\n", debugstr_w(path), GetLastError());
+        free(path);
+        return false;
+    }
+    path[len++] = '\\';
+    path[len] = 0;
+
+    shader_cache.path = path;
+    shader_cache.path_len = len;
+    shader_cache.max_size = (uint64_t)wined3d_settings.shader_cache_size << 20;
+    shader_cache.size = shader_cache_trim(shader_cache.max_size, 0);
+
+    TRACE("Using shader cache %s, size %s, limit %s.\n", debugstr_w(path),
+            wine_dbgstr_longlong(shader_cache.size), wine_dbgstr_longlong(shader_cache.max_size));
+    return true;
+}
+
+static bool shader_cache_read(HANDLE file, void *data, DWORD size)
+{
+    DWORD read;
+
+    return ReadFile(file, data, size, &read, NULL) && read == size;
+}
+
+static bool shader_cache_write(HANDLE file, const void *data, DWORD size)
+{
+    DWORD written;
+
+    return WriteFile(file, data, size, &written, NULL) && written == size;
+}
+
+static bool shader_cache_get(const struct wined3d_shader_cache_key *key, struct vkd3d_shader_code *code)
+{
+    struct wined3d_shader_cache_header header;
+    void *stored_key = NULL, *data = NULL;
+    WCHAR *filename;
+    FILETIME now;
+    HANDLE file;
+
+    if (!(filename = shader_cache_get_filename(key, L".bin")))
+        return false;
+    file = CreateFileW(filename, GENERIC_READ | FILE_WRITE_ATTRIBUTES,
+            FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL, OPEN_EXISTING, 0, NULL);
+    free(filename);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    if (!shader_cache_read(file, &header, sizeof(header))
+            || header.magic != WINED3D_SHADER_CACHE_MAGIC
+            || header.version != WINED3D_SHADER_CACHE_VERSION
+            || header.key_size != key->size
+            || !(stored_key = malloc(header.key_size))
+            || !shader_cache_read(file, stored_key, header.key_size)
+            || memcmp(stored_key, key->data, key->size)
+            || !(data = malloc(header.data_size))
+            || !shader_cache_read(file, data, header.data_size))
+    {
+        free(stored_key);
+        free(data);
+        CloseHandle(file);
+        return false;
+    }
+    free(stored_key);
+
+    /* Mark the entry as recently used. */
+    GetSystemTimeAsFileTime(&now);
+    SetFileTime(file, NULL, NULL, &now);
+    CloseHandle(file);
+
+    code->code = data;
+    code->size = header.data_size;
+    return true;
+}
+
+static void shader_cache_put(const struct wined3d_shader_cache_key *key, const struct vkd3d_shader_code *code)
+{
+    struct wined3d_shader_cache_header header;
+    uint64_t entry_size, old_size = 0, size;
+    WIN32_FILE_ATTRIBUTE_DATA attr;
+    WCHAR *filename, *tmp_filename;
+    WCHAR suffix[] = L".tmp00000000";
+    HANDLE file;
+    bool ret, trim;
+
+    if (code->size > UINT32_MAX)
+        return;
+
+    shader_cache_format_hex(suffix + 4, GetCurrentThreadId(), 8);
+    if (!(filename = shader_cache_get_filename(key, L".bin")))
+        return;
+    if (!(tmp_filename = shader_cache_get_filename(key, suffix)))
+    {
+        free(filename);
+        return;
+    }
+
+    header.magic = WINED3D_SHADER_CACHE_MAGIC;
+    header.version = WINED3D_SHADER_CACHE_VERSION;
+    header.key_size = key->size;
+    header.data_size = code->size;
+
+    if ((file = CreateFileW(tmp_filename, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, 0, NULL)) != INVALID_HANDLE_VALUE)
+    {
+        ret = shader_cache_write(file, &header, sizeof(header))
+                && shader_cache_write(file, key->data, key->size)
+                && shader_cache_write(file, code->code, code->size);
+        CloseHandle(file);
+
+        /* Another thread or process may have added the same entry meanwhile. */
+        if (GetFileAttributesExW(filename, GetFileExInfoStandard, &attr))
+            old_size = ((uint64_t)attr.nFileSizeHigh << 32) | attr.nFileSizeLow;
+
+        /* Readers only ever see complete entries. */
+        if (ret && MoveFileExW(tmp_filename, filename, MOVEFILE_REPLACE_EXISTING))
+        {
+            entry_size = sizeof(header) + key->size + code->size;
+
+            EnterCriticalSection(&shader_cache_cs);
+            shader_cache.bytes_written += entry_size;
+            shader_cache.size += entry_size;
+            shader_cache.size -= min(old_size, shader_cache.size);
+            if ((trim = shader_cache.size > shader_cache.max_size && !shader_cache.trimming))
+                shader_cache.trimming = true;
+            size = shader_cache.size;
+            LeaveCriticalSection(&shader_cache_cs);
+
+            if (trim)
+            {
+                size = shader_cache_trim(shader_cache.max_size - shader_cache.max_size / 4, size);
+                EnterCriticalSection(&shader_cache_cs);
+                shader_cache.size = size;
+                shader_cache.trimming = false;
+                LeaveCriticalSection(&shader_cache_cs);
+            }
+        }
+        else
+        {
+            WARN("Failed to write shader cache entry %s, error %lu.\n", debugstr_w(filename), GetLastError());
+            DeleteFileW(tmp_filename);
+        }
+    }
+
+    free(tmp_filename);
+    free(filename);
+}
+
+/* vkd3d-shader may use a different allocator than wined3d, so its output is
+ * copied. Cached and freshly compiled code can then be freed the same way. */
+static int shader_cache_compile(const struct vkd3d_shader_compile_info *info,
+        struct vkd3d_shader_code *out, char **messages)
+{
+    struct vkd3d_shader_code code;
+    int ret;
+
+    if ((ret = vkd3d_shader_compile(info, &code, messages)) < 0)
+        return ret;
+
+    if (!(out->code = malloc(code.size)))
+    {
+        vkd3d_shader_free_shader_code(&code);
+        return VKD3D_ERROR_OUT_OF_MEMORY;
+    }
+    memcpy((void *)out->code, code.code, code.size);
+    out->size = code.size;
+    vkd3d_shader_free_shader_code(&code);
+
+    return ret;
+}
+
+/* Same as vkd3d_shader_compile(), but the output is looked up in and added to
+ * the shader cache. The output code must be freed with free(). */
+int wined3d_shader_compile(const struct vkd3d_shader_compile_info *info,
+        struct vkd3d_shader_code *out, char **messages)
+{
+    struct wined3d_shader_cache_key key;
+    bool use_cache, hit;
+    int ret;
+
+    EnterCriticalSection(&shader_cache_cs);
+    use_cache = shader_cache_init();
+    LeaveCriticalSection(&shader_cache_cs);
+
+    if (!use_cache || !shader_cache_key_init(&key, info))
+        return shader_cache_compile(info, out, messages);
+
+    hit = shader_cache_get(&key, out);
+
+    EnterCriticalSection(&shader_cache_cs);
+    if (hit)
+    {
+        ++shader_cache.hits;
+        shader_cache.bytes_read += out->size;
+    }
+    else
+    {
+        ++shader_cache.misses;
+    }
+    LeaveCriticalSection(&shader_cache_cs);
+
+    if (hit)
+    {
+        free(key.data);
+        if (messages)
+            *messages = NULL;
+        return VKD3D_OK;
+    }
+
+    if ((ret = shader_cache_compile(info, out, messages)) >= 0)
+        shader_cache_put(&key, out);
+    free(key.data);
+
+    return ret;
+}
+
+void wined3d_shader_cache_cleanup(void)
+{
+    if (shader_cache.path)
+        TRACE_(d3d_perf)("Shader cache: %u hits, %u misses, %s bytes read, %s bytes written.\n",
+                shader_cache.hits, shader_cache.misses, wine_dbgstr_longlong(shader_cache.bytes_read),
+                wine_dbgstr_longlong(shader_cache.bytes_written));
+
+    free(shader_cache.path);
+}
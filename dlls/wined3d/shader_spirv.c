@@ -73,6 +73,23 @@ struct shader_spirv_compile_arguments
     } u;
 };
 
+/* Shader translation is done on the thread pool, so that creating a shader
+ * doesn't stall the command stream. The job keeps its own copy of everything
+ * the compiler needs; the shader byte code is owned by the wined3d_shader,
+ * which waits for its jobs before it is destroyed. */
+struct shader_spirv_compile_job
+{
+    struct wined3d_device_vk *device_vk;
+    struct wined3d_shader_desc shader_desc;
+    enum vkd3d_shader_source_type source_type;
+    enum wined3d_shader_type shader_type;
+    struct shader_spirv_compile_arguments args;
+    struct shader_spirv_resource_bindings bindings;
+
+    VkShaderModule vk_module;
+    bool done;
+};
+
 struct shader_spirv_graphics_program_variant_vk
 {
     struct shader_spirv_compile_arguments compile_args;
@@ -80,6 +97,7 @@ struct shader_spirv_graphics_program_variant_vk
     size_t binding_base;
 
     VkShaderModule vk_module;
+    struct shader_spirv_compile_job *job;
 };
 
 struct shader_spirv_graphics_program_vk
@@ -94,6 +112,7 @@ struct shader_spirv_graphics_program_vk
 struct shader_spirv_compute_program_vk
 {
     VkShaderModule vk_module;
+    struct shader_spirv_compile_job *job;
     VkPipeline vk_pipeline;
     VkPipelineLayout vk_pipeline_layout;
     VkDescriptorSetLayout vk_set_layout;
@@ -252,12 +271,11 @@ static void shader_spirv_init_shader_interface_vk(struct wined3d_shader_spirv_sh
     iface->vkd3d_interface.uav_counter_count = b->uav_counter_count;
 }
 
-static VkShaderModule shader_spirv_compile_shader(struct wined3d_context_vk *context_vk,
+static VkShaderModule shader_spirv_compile_shader(struct wined3d_device_vk *device_vk,
         const struct wined3d_shader_desc *shader_desc, enum vkd3d_shader_source_type source_type,
         enum wined3d_shader_type shader_type, const struct shader_spirv_compile_arguments *args,
         const struct shader_spirv_resource_bindings *bindings, const struct wined3d_stream_output_desc *so_desc)
 {
-    struct wined3d_device_vk *device_vk = wined3d_device_vk(context_vk->c.device);
     const struct wined3d_vk_info *vk_info = &device_vk->vk_info;
     struct wined3d_shader_spirv_compile_args compile_args;
     struct wined3d_shader_spirv_shader_interface iface;
@@ -284,7 +302,7 @@ static VkShaderModule shader_spirv_compile_shader(struct wined3d_context_vk *con
     info.log_level = VKD3D_SHADER_LOG_WARNING;
     info.source_name = NULL;
 
-    ret = vkd3d_shader_compile(&info, &spirv, &messages);
+    ret = wined3d_shader_compile(&info, &spirv, &messages);
     if (messages && *messages && FIXME_ON(d3d_shader))
     {
         const char *ptr, *end, *line;
@@ -313,20 +331,139 @@ static VkShaderModule shader_spirv_compile_shader(struct wined3d_context_vk *con
     shader_create_info.pCode = spirv.code;
     if ((vr = VK_CALL(vkCreateShaderModule(device_vk->vk_device, &shader_create_info, NULL, &module))) < 0)
     {
-        vkd3d_shader_free_shader_code(&spirv);
+        free((void *)spirv.code);
         WARN("Failed to create Vulkan shader module, vr %s.\n", wined3d_debug_vkresult(vr));
         return VK_NULL_HANDLE;
     }
 
-    vkd3d_shader_free_shader_code(&spirv);
+    free((void *)spirv.code);
 
     return module;
 }
 
+static void shader_spirv_get_shader_desc(const struct wined3d_shader *shader, struct wined3d_shader_desc *desc)
+{
+    if (shader->source_type == VKD3D_SHADER_SOURCE_D3D_BYTECODE)
+    {
+        desc->byte_code = shader->function;
+        desc->byte_code_size = shader->functionLength;
+    }
+    else
+    {
+        desc->byte_code = shader->byte_code;
+        desc->byte_code_size = shader->byte_code_size;
+    }
+}
+
+static CRITICAL_SECTION shader_spirv_job_cs;
+static CRITICAL_SECTION_DEBUG shader_spirv_job_cs_debug =
+{
+    0, 0, &shader_spirv_job_cs,
+    {&shader_spirv_job_cs_debug.ProcessLocksList,
+    &shader_spirv_job_cs_debug.ProcessLocksList},
+    0, 0, {(DWORD_PTR)(__FILE__ ": shader_spirv_job_cs")}
+};
+static CRITICAL_SECTION shader_spirv_job_cs = {&shader_spirv_job_cs_debug, -1, 0, 0, 0, 0};
+static CONDITION_VARIABLE shader_spirv_job_cv = CONDITION_VARIABLE_INIT;
+
+static void CALLBACK shader_spirv_compile_job_cb(TP_CALLBACK_INSTANCE *instance, void *ctx)
+{
+    struct shader_spirv_compile_job *job = ctx;
+    VkShaderModule vk_module;
+
+    vk_module = shader_spirv_compile_shader(job->device_vk, &job->shader_desc,
+            job->source_type, job->shader_type, &job->args, &job->bindings, NULL);
+
+    EnterCriticalSection(&shader_spirv_job_cs);
+    job->vk_module = vk_module;
+    job->done = true;
+    WakeAllConditionVariable(&shader_spirv_job_cv);
+    LeaveCriticalSection(&shader_spirv_job_cs);
+}
+
+static struct shader_spirv_compile_job *shader_spirv_compile_job_submit(struct wined3d_device_vk *device_vk,
+        const struct wined3d_shader *shader, enum wined3d_shader_type shader_type,
+        const struct shader_spirv_compile_arguments *args, const struct shader_spirv_resource_bindings *bindings)
+{
+    struct shader_spirv_compile_job *job;
+
+    if (!(job = calloc(1, sizeof(*job))))
+        return NULL;
+
+    if (bindings->binding_count && !(job->bindings.bindings = malloc(bindings->binding_count
+            * sizeof(*job->bindings.bindings))))
+    {
+        free(job);
+        return NULL;
+    }
+
+    job->device_vk = device_vk;
+    shader_spirv_get_shader_desc(shader, &job->shader_desc);
+    job->source_type = shader->source_type;
+    job->shader_type = shader_type;
+    if (args)
+        job->args = *args;
+    if (bindings->binding_count)
+        memcpy(job->bindings.bindings, bindings->bindings, bindings->binding_count * sizeof(*bindings->bindings));
+    job->bindings.bindings_size = job->bindings.binding_count = bindings->binding_count;
+    memcpy(job->bindings.uav_counters, bindings->uav_counters,
+            bindings->uav_counter_count * sizeof(*bindings->uav_counters));
+    job->bindings.uav_counter_count = bindings->uav_counter_count;
+
+    if (!TrySubmitThreadpoolCallback(shader_spirv_compile_job_cb, job, NULL))
+    {
+        WARN("Failed to submit compile job, compiling synchronously.\n");
+        shader_spirv_compile_job_cb(NULL, job);
+    }
+
+    return job;
+}
+
+static bool shader_spirv_compile_job_is_done(const struct shader_spirv_compile_job *job)
+{
+    bool done;
+
+    EnterCriticalSection(&shader_spirv_job_cs);
+    done = job->done;
+    LeaveCriticalSection(&shader_spirv_job_cs);
+
+    return done;
+}
+
+/* Waits for the job to complete, and frees it. */
+static VkShaderModule shader_spirv_compile_job_wait(struct shader_spirv_compile_job *job)
+{
+    VkShaderModule vk_module;
+
+    EnterCriticalSection(&shader_spirv_job_cs);
+    while (!job->done)
+        SleepConditionVariableCS(&shader_spirv_job_cv, &shader_spirv_job_cs, INFINITE);
+    LeaveCriticalSection(&shader_spirv_job_cs);
+
+    vk_module = job->vk_module;
+    free(job->bindings.bindings);
+    free(job);
+
+    return vk_module;
+}
+
+static VkShaderModule shader_spirv_graphics_program_variant_resolve(
+        struct shader_spirv_graphics_program_variant_vk *variant_vk)
+{
+    if (variant_vk->job)
+    {
+        variant_vk->vk_module = shader_spirv_compile_job_wait(variant_vk->job);
+        variant_vk->job = NULL;
+    }
+
+    return variant_vk->vk_module;
+}
+
 static struct shader_spirv_graphics_program_variant_vk *shader_spirv_find_graphics_program_variant_vk(
         struct shader_spirv_priv *priv, struct wined3d_context_vk *context_vk, struct wined3d_shader *shader,
         const struct wined3d_state *state, const struct shader_spirv_resource_bindings *bindings)
 {
+    struct wined3d_device_vk *device_vk = wined3d_device_vk(context_vk->c.device);
     enum wined3d_shader_type shader_type = shader->reg_maps.shader_version.type;
     struct shader_spirv_graphics_program_variant_vk *variant_vk;
     size_t binding_base = bindings->binding_base[shader_type];
@@ -358,20 +495,22 @@ static struct shader_spirv_graphics_program_variant_vk *shader_spirv_find_graphi
 
     variant_vk = &program_vk->variants[variant_count];
     variant_vk->compile_args = args;
+    variant_vk->so_desc = so_desc;
     variant_vk->binding_base = binding_base;
+    variant_vk->vk_module = VK_NULL_HANDLE;
+    variant_vk->job = NULL;
 
-    if (shader->source_type == VKD3D_SHADER_SOURCE_D3D_BYTECODE)
+    /* The stream output description is owned by the geometry shader, and
+     * can't be handed to the thread pool. Such variants are rare. */
+    if (!so_desc && (variant_vk->job = shader_spirv_compile_job_submit(device_vk,
+            shader, shader_type, &args, bindings)))
     {
-        shader_desc.byte_code = shader->function;
-        shader_desc.byte_code_size = shader->functionLength;
-    }
-    else
-    {
-        shader_desc.byte_code = shader->byte_code;
-        shader_desc.byte_code_size = shader->byte_code_size;
+        ++program_vk->variant_count;
+        return variant_vk;
     }
 
-    if (!(variant_vk->vk_module = shader_spirv_compile_shader(context_vk, &shader_desc,
+    shader_spirv_get_shader_desc(shader, &shader_desc);
+    if (!(variant_vk->vk_module = shader_spirv_compile_shader(device_vk, &shader_desc,
             shader->source_type, shader_type, &args, bindings, so_desc)))
         return NULL;
     ++program_vk->variant_count;
@@ -397,11 +536,20 @@ static struct shader_spirv_compute_program_vk *shader_spirv_find_compute_program
     if (program->vk_module)
         return program;
 
-    shader_desc.byte_code = shader->byte_code;
-    shader_desc.byte_code_size = shader->byte_code_size;
+    if (program->job)
+    {
+        program->vk_module = shader_spirv_compile_job_wait(program->job);
+        program->job = NULL;
+    }
+    else
+    {
+        shader_desc.byte_code = shader->byte_code;
+        shader_desc.byte_code_size = shader->byte_code_size;
 
-    if (!(program->vk_module = shader_spirv_compile_shader(context_vk, &shader_desc,
-            shader->source_type, WINED3D_SHADER_TYPE_COMPUTE, NULL, bindings, NULL)))
+        program->vk_module = shader_spirv_compile_shader(device_vk, &shader_desc,
+                shader->source_type, WINED3D_SHADER_TYPE_COMPUTE, NULL, bindings, NULL);
+    }
+    if (!program->vk_module)
         return NULL;
 
     if (!(layout = wined3d_context_vk_get_pipeline_layout(context_vk,
@@ -623,20 +771,71 @@ static enum wined3d_data_type wined3d_data_type_from_vkd3d(enum vkd3d_shader_res
     }
 }
 
-static bool shader_spirv_resource_bindings_init(struct shader_spirv_resource_bindings *bindings,
-        struct wined3d_shader_resource_bindings *wined3d_bindings,
-        const struct wined3d_state *state, uint32_t shader_mask)
+static bool shader_spirv_resource_bindings_add_shader(struct shader_spirv_resource_bindings *bindings,
+        struct wined3d_shader_resource_bindings *wined3d_bindings, enum wined3d_shader_type shader_type,
+        const struct vkd3d_shader_scan_descriptor_info *descriptor_info)
 {
-    const struct vkd3d_shader_scan_descriptor_info *descriptor_info;
     enum wined3d_shader_descriptor_type wined3d_type;
     enum vkd3d_shader_visibility shader_visibility;
-    enum wined3d_shader_type shader_type;
     VkDescriptorType vk_descriptor_type;
     VkShaderStageFlagBits vk_stage;
-    struct wined3d_shader *shader;
     size_t binding_idx;
     unsigned int i;
 
+    vk_stage = vk_shader_stage_from_wined3d(shader_type);
+    shader_visibility = vkd3d_shader_visibility_from_wined3d(shader_type);
+
+    for (i = 0; i < descriptor_info->descriptor_count; ++i)
+    {
+        const struct vkd3d_shader_descriptor_info *d = &descriptor_info->descriptors[i];
+        uint32_t flags;
+
+        if (d->register_space)
+        {
+            WARN("Unsupported register space %u.\n", d->register_space);
+            return false;
+        }
+
+        if (d->resource_type == VKD3D_SHADER_RESOURCE_BUFFER)
+            flags = VKD3D_SHADER_BINDING_FLAG_BUFFER;
+        else
+            flags = VKD3D_SHADER_BINDING_FLAG_IMAGE;
+
+        vk_descriptor_type = vk_descriptor_type_from_vkd3d(d->type, d->resource_type);
+        if (!shader_spirv_resource_bindings_add_binding(bindings, d->type, vk_descriptor_type,
+                d->register_index, shader_visibility, vk_stage, flags, &binding_idx))
+            return false;
+
+        wined3d_type = wined3d_descriptor_type_from_vkd3d(d->type);
+        if (wined3d_bindings && !wined3d_shader_resource_bindings_add_binding(wined3d_bindings, shader_type,
+                wined3d_type, d->register_index, wined3d_shader_resource_type_from_vkd3d(d->resource_type),
+                wined3d_data_type_from_vkd3d(d->resource_data_type), binding_idx))
+            return false;
+
+        if (d->type == VKD3D_SHADER_DESCRIPTOR_TYPE_UAV
+                && (d->flags & VKD3D_SHADER_DESCRIPTOR_INFO_FLAG_UAV_COUNTER))
+        {
+            if (!shader_spirv_resource_bindings_add_uav_counter_binding(bindings,
+                    d->register_index, shader_visibility, vk_stage, &binding_idx))
+                return false;
+            if (wined3d_bindings && !wined3d_shader_resource_bindings_add_binding(wined3d_bindings,
+                    shader_type, WINED3D_SHADER_DESCRIPTOR_TYPE_UAV_COUNTER, d->register_index,
+                    WINED3D_SHADER_RESOURCE_BUFFER, WINED3D_DATA_UINT, binding_idx))
+                return false;
+        }
+    }
+
+    return true;
+}
+
+static bool shader_spirv_resource_bindings_init(struct shader_spirv_resource_bindings *bindings,
+        struct wined3d_shader_resource_bindings *wined3d_bindings,
+        const struct wined3d_state *state, uint32_t shader_mask)
+{
+    const struct vkd3d_shader_scan_descriptor_info *descriptor_info;
+    enum wined3d_shader_type shader_type;
+    struct wined3d_shader *shader;
+
     bindings->binding_count = 0;
     bindings->uav_counter_count = 0;
     bindings->vk_binding_count = 0;
@@ -661,48 +860,8 @@ static bool shader_spirv_resource_bindings_init(struct shader_spirv_resource_bin
                 bindings->so_stage = WINED3D_SHADER_TYPE_VERTEX;
         }
 
-        vk_stage = vk_shader_stage_from_wined3d(shader_type);
-        shader_visibility = vkd3d_shader_visibility_from_wined3d(shader_type);
-
-        for (i = 0; i < descriptor_info->descriptor_count; ++i)
-        {
-            const struct vkd3d_shader_descriptor_info *d = &descriptor_info->descriptors[i];
-            uint32_t flags;
-
-            if (d->register_space)
-            {
-                WARN("Unsupported register space %u.\n", d->register_space);
-                return false;
-            }
-
-            if (d->resource_type == VKD3D_SHADER_RESOURCE_BUFFER)
-                flags = VKD3D_SHADER_BINDING_FLAG_BUFFER;
-            else
-                flags = VKD3D_SHADER_BINDING_FLAG_IMAGE;
-
-            vk_descriptor_type = vk_descriptor_type_from_vkd3d(d->type, d->resource_type);
-            if (!shader_spirv_resource_bindings_add_binding(bindings, d->type, vk_descriptor_type,
-                    d->register_index, shader_visibility, vk_stage, flags, &binding_idx))
-                return false;
-
-            wined3d_type = wined3d_descriptor_type_from_vkd3d(d->type);
-            if (!wined3d_shader_resource_bindings_add_binding(wined3d_bindings, shader_type,
-                    wined3d_type, d->register_index, wined3d_shader_resource_type_from_vkd3d(d->resource_type),
-                    wined3d_data_type_from_vkd3d(d->resource_data_type), binding_idx))
-                return false;
-
-            if (d->type == VKD3D_SHADER_DESCRIPTOR_TYPE_UAV
-                    && (d->flags & VKD3D_SHADER_DESCRIPTOR_INFO_FLAG_UAV_COUNTER))
-            {
-                if (!shader_spirv_resource_bindings_add_uav_counter_binding(bindings,
-                        d->register_index, shader_visibility, vk_stage, &binding_idx))
-                    return false;
-                if (!wined3d_shader_resource_bindings_add_binding(wined3d_bindings,
-                        shader_type, WINED3D_SHADER_DESCRIPTOR_TYPE_UAV_COUNTER, d->register_index,
-                        WINED3D_SHADER_RESOURCE_BUFFER, WINED3D_DATA_UINT, binding_idx))
-                    return false;
-            }
-        }
+        if (!shader_spirv_resource_bindings_add_shader(bindings, wined3d_bindings, shader_type, descriptor_info))
+            return false;
     }
 
     return true;
@@ -765,6 +924,7 @@ static void shader_spirv_scan_shader(struct wined3d_shader *shader,
 
 static void shader_spirv_precompile_compute(struct wined3d_shader *shader)
 {
+    struct shader_spirv_resource_bindings bindings = {0};
     struct shader_spirv_compute_program_vk *program_vk;
 
     if (!(program_vk = shader->backend_data))
@@ -775,6 +935,56 @@ static void shader_spirv_precompile_compute(struct wined3d_shader *shader)
     }
 
     shader_spirv_scan_shader(shader, &program_vk->descriptor_info, NULL);
+
+    /* Compute shaders are the only stage in their pipeline layout, so the
+     * final module can be built right away. */
+    if (!program_vk->vk_module && !program_vk->job && shader_spirv_resource_bindings_add_shader(&bindings,
+            NULL, WINED3D_SHADER_TYPE_COMPUTE, &program_vk->descriptor_info))
+        program_vk->job = shader_spirv_compile_job_submit(wined3d_device_vk(shader->device),
+                shader, WINED3D_SHADER_TYPE_COMPUTE, NULL, &bindings);
+    shader_spirv_resource_bindings_cleanup(&bindings);
+}
+
+/* Pixel shaders always use the start of the descriptor set layout, so we
+ * can start compiling the variant for the current render state before the
+ * shader is used. The bindings of the other stages depend on the pixel
+ * shader, and aren't known at this point. */
+static void shader_spirv_precompile_pixel(struct wined3d_shader *shader,
+        struct shader_spirv_graphics_program_vk *program_vk)
+{
+    struct shader_spirv_graphics_program_variant_vk *variant_vk;
+    struct shader_spirv_resource_bindings bindings = {0};
+    struct wined3d_device *device = shader->device;
+    struct wined3d_context_vk *context_vk;
+    unsigned int sample_count;
+
+    if (!shader->function || program_vk->variant_count)
+        return;
+
+    if (!shader_spirv_resource_bindings_add_shader(&bindings, NULL,
+            WINED3D_SHADER_TYPE_PIXEL, &program_vk->descriptor_info))
+        goto done;
+
+    if (!wined3d_array_reserve((void **)&program_vk->variants, &program_vk->variants_size,
+            1, sizeof(*program_vk->variants)))
+        goto done;
+
+    variant_vk = &program_vk->variants[0];
+    context_vk = wined3d_context_vk(context_acquire(device, NULL, 0));
+    if (!(sample_count = context_vk->sample_count))
+        sample_count = VK_SAMPLE_COUNT_1_BIT;
+    shader_spirv_compile_arguments_init(&variant_vk->compile_args, &context_vk->c,
+            shader, &device->cs->state, sample_count);
+    context_release(&context_vk->c);
+    variant_vk->so_desc = NULL;
+    variant_vk->binding_base = 0;
+    variant_vk->vk_module = VK_NULL_HANDLE;
+    if ((variant_vk->job = shader_spirv_compile_job_submit(wined3d_device_vk(device),
+            shader, WINED3D_SHADER_TYPE_PIXEL, &variant_vk->compile_args, &bindings)))
+        program_vk->variant_count = 1;
+
+done:
+    shader_spirv_resource_bindings_cleanup(&bindings);
 }
 
 static void shader_spirv_precompile(void *shader_priv, struct wined3d_shader *shader)
@@ -797,19 +1007,26 @@ static void shader_spirv_precompile(void *shader_priv, struct wined3d_shader *sh
     }
 
     shader_spirv_scan_shader(shader, &program_vk->descriptor_info, &program_vk->signature_info);
+
+    if (shader->reg_maps.shader_version.type == WINED3D_SHADER_TYPE_PIXEL)
+        shader_spirv_precompile_pixel(shader, program_vk);
 }
 
 static void shader_spirv_apply_draw_state(void *shader_priv, struct wined3d_context *context,
         const struct wined3d_state *state)
 {
+    struct shader_spirv_graphics_program_variant_vk *variants[WINED3D_SHADER_TYPE_GRAPHICS_COUNT];
     struct wined3d_context_vk *context_vk = wined3d_context_vk(context);
-    struct shader_spirv_graphics_program_variant_vk *variant_vk;
     struct shader_spirv_resource_bindings *bindings;
     size_t binding_base[WINED3D_SHADER_TYPE_COUNT];
     struct wined3d_pipeline_layout_vk *layout_vk;
     struct shader_spirv_priv *priv = shader_priv;
     enum wined3d_shader_type shader_type;
+    uint32_t update_mask = 0;
     struct wined3d_shader *shader;
+    bool pending = false;
+
+    context_vk->shaders_pending = 0;
 
     priv->vertex_pipe->vp_apply_draw_state(context, state);
     priv->fragment_pipe->fp_apply_draw_state(context, state);
@@ -829,21 +1046,57 @@ static void shader_spirv_apply_draw_state(void *shader_priv, struct wined3d_cont
     context_vk->graphics.vk_set_layout = layout_vk->vk_set_layout;
     context_vk->graphics.vk_pipeline_layout = layout_vk->vk_pipeline_layout;
 
+    /* Look up (and start compiling) the variants for all stages first, so
+     * that they are translated in parallel. */
     for (shader_type = 0; shader_type < ARRAY_SIZE(context_vk->graphics.vk_modules); ++shader_type)
     {
+        variants[shader_type] = NULL;
+
         if (!(context->shader_update_mask & (1u << shader_type)) && (!context_vk->graphics.vk_modules[shader_type]
                 || binding_base[shader_type] == bindings->binding_base[shader_type]))
             continue;
+        update_mask |= 1u << shader_type;
 
         if (!(shader = state->shader[shader_type]) || !shader->function)
+            continue;
+
+        if (!(variants[shader_type] = shader_spirv_find_graphics_program_variant_vk(priv,
+                context_vk, shader, state, bindings)))
+            goto fail;
+    }
+
+    for (shader_type = 0; shader_type < ARRAY_SIZE(context_vk->graphics.vk_modules); ++shader_type)
+    {
+        if (!variants[shader_type] || !variants[shader_type]->job)
+            continue;
+
+        if (wined3d_settings.async_shaders && !shader_spirv_compile_job_is_done(variants[shader_type]->job))
+            pending = true;
+        else
+            shader_spirv_graphics_program_variant_resolve(variants[shader_type]);
+    }
+
+    if (pending)
+    {
+        /* Retry the whole update on the next draw. */
+        context->shader_update_mask |= update_mask;
+        context_vk->shaders_pending = 1;
+        goto fail;
+    }
+
+    for (shader_type = 0; shader_type < ARRAY_SIZE(context_vk->graphics.vk_modules); ++shader_type)
+    {
+        if (!(update_mask & (1u << shader_type)))
+            continue;
+
+        if (!variants[shader_type])
         {
             context_vk->graphics.vk_modules[shader_type] = VK_NULL_HANDLE;
             continue;
         }
 
-        if (!(variant_vk = shader_spirv_find_graphics_program_variant_vk(priv, context_vk, shader, state, bindings)))
+        if (!(context_vk->graphics.vk_modules[shader_type] = variants[shader_type]->vk_module))
             goto fail;
-        context_vk->graphics.vk_modules[shader_type] = variant_vk->vk_module;
     }
 
     return;
@@ -965,6 +1218,8 @@ static void shader_spirv_destroy_compute_vk(struct wined3d_shader *shader)
     struct wined3d_context_vk *context_vk = &device_vk->context_vk;
     struct wined3d_vk_info *vk_info = &device_vk->vk_info;
 
+    if (program->job)
+        program->vk_module = shader_spirv_compile_job_wait(program->job);
     shader_spirv_invalidate_contexts_compute_program(&device_vk->d, program);
     wined3d_context_vk_destroy_vk_pipeline(context_vk, program->vk_pipeline, context_vk->current_command_buffer.id);
     VK_CALL(vkDestroyShaderModule(device_vk->vk_device, program->vk_module, NULL));
@@ -994,6 +1249,8 @@ static void shader_spirv_destroy(struct wined3d_shader *shader)
     for (i = 0; i < program_vk->variant_count; ++i)
     {
         variant_vk = &program_vk->variants[i];
+        if (!shader_spirv_graphics_program_variant_resolve(variant_vk))
+            continue;
         shader_spirv_invalidate_contexts_graphics_program_variant(&device_vk->d, variant_vk);
         VK_CALL(vkDestroyShaderModule(device_vk->vk_device, variant_vk->vk_module, NULL));
     }
@@ -1090,7 +1347,7 @@ static uint64_t shader_spirv_compile(struct wined3d_context *context, const stru
         enum wined3d_shader_type shader_type)
 {
     struct shader_spirv_resource_bindings bindings = {0};
-    return (uint64_t)shader_spirv_compile_shader(wined3d_context_vk(context), shader_desc,
+    return (uint64_t)shader_spirv_compile_shader(wined3d_device_vk(context->device), shader_desc,
             VKD3D_SHADER_SOURCE_DXBC_TPF, shader_type, NULL, &bindings, NULL);
 }
 
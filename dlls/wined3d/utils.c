@@ -4185,6 +4185,61 @@ BOOL wined3d_adapter_no3d_init_format_info(struct wined3d_adapter *adapter)
     return TRUE;
 }
 
+/* The null adapter never touches the data, so every format is usable for
+ * everything it could plausibly be used for. */
+BOOL wined3d_adapter_null_init_format_info(struct wined3d_adapter *adapter)
+{
+    struct wined3d_format *format;
+    unsigned int caps, i;
+
+    if (!wined3d_adapter_init_format_info(adapter, sizeof(struct wined3d_format)))
+        return FALSE;
+
+    for (i = 0; i < WINED3D_FORMAT_COUNT; ++i)
+    {
+        format = get_format_by_idx(adapter, i);
+
+        if (!format->id || !format->byte_count)
+            continue;
+
+        caps = WINED3D_FORMAT_CAP_TEXTURE | WINED3D_FORMAT_CAP_VTF | WINED3D_FORMAT_CAP_BLIT;
+        if (format->depth_size || format->stencil_size)
+        {
+            caps |= WINED3D_FORMAT_CAP_DEPTH_STENCIL | WINED3D_FORMAT_CAP_SHADOW;
+            format->multisample_types = (1u << 1) | (1u << 3) | (1u << 7);
+        }
+        else if (!(format->attrs & WINED3D_FORMAT_ATTR_COMPRESSED))
+        {
+            caps |= WINED3D_FORMAT_CAP_FILTERING | WINED3D_FORMAT_CAP_RENDERTARGET
+                    | WINED3D_FORMAT_CAP_POSTPIXELSHADER_BLENDING | WINED3D_FORMAT_CAP_UNORDERED_ACCESS
+                    | WINED3D_FORMAT_CAP_GEN_MIPMAP;
+            format->multisample_types = (1u << 1) | (1u << 3) | (1u << 7);
+
+            format->caps[WINED3D_GL_RES_TYPE_BUFFER] |= WINED3D_FORMAT_CAP_VERTEX_ATTRIBUTE
+                    | WINED3D_FORMAT_CAP_TEXTURE | WINED3D_FORMAT_CAP_UNORDERED_ACCESS;
+        }
+        else
+        {
+            caps |= WINED3D_FORMAT_CAP_FILTERING;
+        }
+
+        format->caps[WINED3D_GL_RES_TYPE_TEX_1D] |= caps;
+        format->caps[WINED3D_GL_RES_TYPE_TEX_2D] |= caps;
+        format->caps[WINED3D_GL_RES_TYPE_TEX_3D] |= caps;
+        format->caps[WINED3D_GL_RES_TYPE_TEX_CUBE] |= caps;
+        format->caps[WINED3D_GL_RES_TYPE_RB] |= caps;
+    }
+
+    if (!init_typeless_formats(adapter))
+    {
+        free(adapter->formats);
+        adapter->formats = NULL;
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
 /* Context activation is done by the caller. */
 BOOL wined3d_adapter_gl_init_format_info(struct wined3d_adapter *adapter, struct wined3d_caps_gl_ctx *ctx)
 {
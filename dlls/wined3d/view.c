@@ -1118,6 +1118,16 @@ static HRESULT wined3d_shader_resource_view_init(struct wined3d_shader_resource_
     return WINED3D_OK;
 }
 
+HRESULT wined3d_shader_resource_view_null_init(struct wined3d_shader_resource_view *view_null,
+        const struct wined3d_view_desc *desc, struct wined3d_resource *resource,
+        void *parent, const struct wined3d_parent_ops *parent_ops)
+{
+    TRACE("view_null %p, desc %s, resource %p, parent %p, parent_ops %p.\n",
+            view_null, wined3d_debug_view_desc(desc, resource), resource, parent, parent_ops);
+
+    return wined3d_shader_resource_view_init(view_null, desc, resource, parent, parent_ops);
+}
+
 HRESULT wined3d_shader_resource_view_gl_init(struct wined3d_shader_resource_view_gl *view_gl,
         const struct wined3d_view_desc *desc, struct wined3d_resource *resource,
         void *parent, const struct wined3d_parent_ops *parent_ops)
@@ -1830,6 +1840,16 @@ static HRESULT wined3d_unordered_access_view_init(struct wined3d_unordered_acces
     return WINED3D_OK;
 }
 
+HRESULT wined3d_unordered_access_view_null_init(struct wined3d_unordered_access_view *view_null,
+        const struct wined3d_view_desc *desc, struct wined3d_resource *resource,
+        void *parent, const struct wined3d_parent_ops *parent_ops)
+{
+    TRACE("view_null %p, desc %s, resource %p, parent %p, parent_ops %p.\n",
+            view_null, wined3d_debug_view_desc(desc, resource), resource, parent, parent_ops);
+
+    return wined3d_unordered_access_view_init(view_null, desc, resource, parent, parent_ops);
+}
+
 HRESULT wined3d_unordered_access_view_gl_init(struct wined3d_unordered_access_view_gl *view_gl,
         const struct wined3d_view_desc *desc, struct wined3d_resource *resource,
         void *parent, const struct wined3d_parent_ops *parent_ops)
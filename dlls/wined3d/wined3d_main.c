@@ -500,6 +500,11 @@ static BOOL wined3d_dll_init(HINSTANCE hInstDLL)
                 ERR_(winediag)("Disabling 3D support.\n");
                 wined3d_settings.renderer = WINED3D_RENDERER_NO3D;
             }
+            else if (!strcmp(buffer, "null"))
+            {
+                ERR_(winediag)("Using the null renderer; nothing will be drawn.\n");
+                wined3d_settings.renderer = WINED3D_RENDERER_NULL;
+            }
         }
         if (!get_config_key_dword(hkey, appkey, env, "cb_access_map_w", &tmpvalue) && tmpvalue)
         {
@@ -511,6 +516,18 @@ static BOOL wined3d_dll_init(HINSTANCE hInstDLL)
             ERR_(winediag)("Using the HLSL-based FFP backend.\n");
             wined3d_settings.ffp_hlsl = tmpvalue;
         }
+        if (!get_config_key_dword(hkey, appkey, env, "ShaderCacheSize", &wined3d_settings.shader_cache_size))
+            TRACE("Limiting shader cache size to %u MiB.\n", wined3d_settings.shader_cache_size);
+        if (!get_config_key(hkey, appkey, env, "ShaderCachePath", buffer, size))
+        {
+            TRACE("Using shader cache path %s.\n", debugstr_a(buffer));
+            wined3d_settings.shader_cache_path = strdup(buffer);
+        }
+        if (!get_config_key_dword(hkey, appkey, env, "AsyncShaders", &tmpvalue) && tmpvalue)
+        {
+            TRACE("Skipping draws until their shaders are compiled.\n");
+            wined3d_settings.async_shaders = true;
+        }
     }
 
     if (appkey) RegCloseKey( appkey );
@@ -570,6 +587,8 @@ static BOOL wined3d_dll_destroy(HINSTANCE hInstDLL)
     free(swapchain_state_table.hooks);
 
     free(wined3d_settings.logo);
+    free(wined3d_settings.shader_cache_path);
+    wined3d_shader_cache_cleanup();
     UnregisterClassA(WINED3D_OPENGL_WINDOW_CLASS_NAME, hInstDLL);
 
     DeleteCriticalSection(&wined3d_command_cs);
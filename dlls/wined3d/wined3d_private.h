@@ -491,6 +491,9 @@ struct wined3d_settings
     bool check_float_constants;
     bool cb_access_map_w;
     bool ffp_hlsl;
+    unsigned int shader_cache_size;
+    char *shader_cache_path;
+    bool async_shaders;
 };
 
 extern struct wined3d_settings wined3d_settings;
@@ -1568,6 +1571,7 @@ struct wined3d_shader_backend_ops
 
 extern const struct wined3d_shader_backend_ops glsl_shader_backend;
 extern const struct wined3d_shader_backend_ops none_shader_backend;
+extern const struct wined3d_shader_backend_ops null_shader_backend;
 
 const struct wined3d_shader_backend_ops *wined3d_spirv_shader_backend_init_vk(void);
 
@@ -1869,6 +1873,9 @@ struct wined3d_query
     bool poll_in_cs;
 };
 
+HRESULT wined3d_query_null_create(struct wined3d_device *device, enum wined3d_query_type type, void *parent,
+        const struct wined3d_parent_ops *parent_ops, struct wined3d_query **query);
+
 #define WINED3D_QUERY_POOL_SIZE 256
 
 struct wined3d_range
@@ -2625,6 +2632,7 @@ struct wined3d_adapter *wined3d_adapter_gl_create(unsigned int ordinal,
         unsigned int wined3d_creation_flags);
 
 BOOL wined3d_adapter_no3d_init_format_info(struct wined3d_adapter *adapter);
+BOOL wined3d_adapter_null_init_format_info(struct wined3d_adapter *adapter);
 ssize_t adapter_adjust_mapped_memory(struct wined3d_adapter *adapter, ssize_t size);
 UINT64 adapter_adjust_memory(struct wined3d_adapter *adapter, INT64 amount);
 
@@ -3542,6 +3550,9 @@ struct wined3d_sampler
     struct wined3d_sampler_desc desc;
 };
 
+void wined3d_sampler_null_init(struct wined3d_sampler *sampler_null, struct wined3d_device *device,
+        const struct wined3d_sampler_desc *desc, void *parent, const struct wined3d_parent_ops *parent_ops);
+
 struct wined3d_vertex_declaration_element
 {
     const struct wined3d_format *format;
@@ -3593,6 +3604,8 @@ enum wined3d_cs_queue_id
 #define WINED3D_CS_QUEUE_SIZE           0x400000u
 #endif
 #define WINED3D_CS_SPIN_COUNT           2000u
+#define WINED3D_CS_SPIN_COUNT_MIN       250u
+#define WINED3D_CS_SPIN_COUNT_MAX       4000u
 /* How long to wait for commands when there are active queries, in µs. */
 #define WINED3D_CS_COMMAND_WAIT_WITH_QUERIES_TIMEOUT 100
 /* How long to wait for the CS from the client thread, in µs. */
@@ -3962,6 +3975,9 @@ struct wined3d_shader_resource_view
 
 void wined3d_shader_resource_view_cleanup(struct wined3d_shader_resource_view *view);
 void wined3d_shader_resource_view_destroy(struct wined3d_shader_resource_view *view);
+HRESULT wined3d_shader_resource_view_null_init(struct wined3d_shader_resource_view *view_null,
+        const struct wined3d_view_desc *desc, struct wined3d_resource *resource,
+        void *parent, const struct wined3d_parent_ops *parent_ops);
 
 static inline struct wined3d_texture *wined3d_state_get_ffp_texture(const struct wined3d_state *state, unsigned int idx)
 {
@@ -3986,6 +4002,9 @@ struct wined3d_unordered_access_view
 };
 
 void wined3d_unordered_access_view_cleanup(struct wined3d_unordered_access_view *view);
+HRESULT wined3d_unordered_access_view_null_init(struct wined3d_unordered_access_view *view_null,
+        const struct wined3d_view_desc *desc, struct wined3d_resource *resource,
+        void *parent, const struct wined3d_parent_ops *parent_ops);
 void wined3d_unordered_access_view_copy_counter(struct wined3d_unordered_access_view *view,
         struct wined3d_buffer *buffer, unsigned int offset, struct wined3d_context *context);
 void wined3d_unordered_access_view_invalidate_location(struct wined3d_unordered_access_view *view,
@@ -4321,6 +4340,10 @@ bool ffp_hlsl_compile_vs(const struct wined3d_ffp_vs_settings *settings,
         struct wined3d_shader_desc *shader_desc, struct wined3d_device *device);
 bool ffp_hlsl_compile_ps(const struct ffp_frag_settings *settings, struct wined3d_shader_desc *shader_desc);
 
+int wined3d_shader_compile(const struct vkd3d_shader_compile_info *info,
+        struct vkd3d_shader_code *out, char **messages);
+void wined3d_shader_cache_cleanup(void);
+
 static inline BOOL shader_is_scalar(const struct wined3d_shader_register *reg)
 {
     switch (reg->type)
@@ -0,0 +1,41 @@
+/*
+ * Copyright (C) the Wine project
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+
+#ifndef __WINE_WINE_D3DCOMPILER_H
+#define __WINE_WINE_D3DCOMPILER_H
+
+#include "d3dcompiler.h"
+
+/* Wine-specific extension: compile several permutations of the same source,
+ * differing only by macros, entry point, target or flags, in one call. */
+struct wine_d3d_compile_job
+{
+    const D3D_SHADER_MACRO *defines;
+    const char *entry_point;
+    const char *target;
+    UINT flags1;
+    UINT flags2;
+    ID3DBlob *shader;
+    ID3DBlob *error_messages;
+    HRESULT hr;
+};
+
+typedef HRESULT (WINAPI *pwine_D3DCompileBatch)(const void *data, SIZE_T data_size, const char *filename,
+        ID3DInclude *include, struct wine_d3d_compile_job *jobs, UINT job_count);
+
+#endif  /* __WINE_WINE_D3DCOMPILER_H */
@@ -3020,6 +3020,8 @@ enum message_type
     MSG_HOOK_LL
 };
 #define SEND_MSG_ABORT_IF_HUNG  0x01
+#define SEND_MSG_WAIT_REPLY     0x02
+#define SEND_MSG_BLOCK          0x04
 
 
 
@@ -6990,7 +6992,7 @@ union generic_reply
 
 /* ### protocol_version begin ### */
 
-#define SERVER_PROTOCOL_VERSION 1795
+#define SERVER_PROTOCOL_VERSION 1796
 
 /* ### protocol_version end ### */
 
@@ -3144,6 +3144,41 @@ DECL_HANDLER(set_queue_fd)
 }
 
 
+/* set the wake and changed masks of a queue, as done by the set_queue_mask request */
+static void set_queue_masks( struct msg_queue *queue, unsigned int wake_mask,
+                             unsigned int changed_mask, int skip_wait )
+{
+    const queue_shm_t *queue_shm = queue->shared;
+
+    SHARED_WRITE_BEGIN( queue_shm, queue_shm_t )
+    {
+        shared->wake_mask = wake_mask;
+        shared->changed_mask = changed_mask;
+    }
+    SHARED_WRITE_END;
+
+    if (is_signaled( queue ))
+    {
+        /* if skip wait is set, do what would have been done in the subsequent wait */
+        if (skip_wait)
+        {
+            SHARED_WRITE_BEGIN( queue_shm, queue_shm_t )
+            {
+                shared->wake_mask = 0;
+                shared->changed_mask = 0;
+            }
+            SHARED_WRITE_END;
+        }
+        else wake_up( &queue->obj, 0 );
+    }
+    if (do_msync() && !is_signaled( queue ))
+        msync_clear( &queue->obj );
+
+    if (do_esync() && !is_signaled( queue ))
+        esync_clear( queue->esync_fd );
+}
+
+
 /* set the current message queue wakeup mask */
 DECL_HANDLER(set_queue_mask)
 {
@@ -3153,35 +3188,9 @@ DECL_HANDLER(set_queue_mask)
     {
         const queue_shm_t *queue_shm = queue->shared;
 
-        SHARED_WRITE_BEGIN( queue_shm, queue_shm_t )
-        {
-            shared->wake_mask = req->wake_mask;
-            shared->changed_mask = req->changed_mask;
-        }
-        SHARED_WRITE_END;
-
+        set_queue_masks( queue, req->wake_mask, req->changed_mask, req->skip_wait );
         reply->wake_bits    = queue_shm->wake_bits;
         reply->changed_bits = queue_shm->changed_bits;
-
-        if (is_signaled( queue ))
-        {
-            /* if skip wait is set, do what would have been done in the subsequent wait */
-            if (req->skip_wait)
-            {
-                SHARED_WRITE_BEGIN( queue_shm, queue_shm_t )
-                {
-                    shared->wake_mask = 0;
-                    shared->changed_mask = 0;
-                }
-                SHARED_WRITE_END;
-            }
-            else wake_up( &queue->obj, 0 );
-        }
-        if (do_msync() && !is_signaled( queue ))
-            msync_clear( &queue->obj );
-
-        if (do_esync() && !is_signaled( queue ))
-            esync_clear( queue->esync_fd );
     }
 }
 
@@ -3266,6 +3275,12 @@ DECL_HANDLER(send_message)
                 free_message( msg );
                 break;
             }
+            /* save the sender a set_queue_mask request before waiting for the reply */
+            if (req->flags & SEND_MSG_WAIT_REPLY)
+            {
+                unsigned int mask = QS_SMRESULT | ((req->flags & SEND_MSG_BLOCK) ? 0 : QS_SENDMESSAGE);
+                set_queue_masks( send_queue, mask, mask, 1 );
+            }
             /* fall through */
         case MSG_NOTIFY:
             list_add_tail( &recv_queue->msg_list[SEND_MESSAGE], &msg->entry );
@@ -81,16 +81,27 @@ SOFTWARE.
 #include "request.h"
 #include "user.h"
 
+#define RGN_DEFAULT_RECTS 2
+
 struct region
 {
     int size;
     int num_rects;
     struct rectangle *rects;
     struct rectangle extents;
+    struct rectangle rects_buf[RGN_DEFAULT_RECTS];  /* inline storage for small regions */
 };
 
+#define MAX_CACHED_REGIONS 16
+#define MAX_SPARE_RECTS    4096
 
-#define RGN_DEFAULT_RECTS 2
+/* regions are created and freed on every visible region computation, so keep a few around */
+static struct region *cached_regions[MAX_CACHED_REGIONS];
+static unsigned int nb_cached_regions;
+
+/* spare rectangle array reused by region_op instead of allocating a new one each time */
+static struct rectangle *spare_rects;
+static int spare_size;
 
 #define EXTENTCHECK(r1, r2) \
     ((r1)->right > (r2)->left && \
@@ -105,20 +116,73 @@ typedef int (*non_overlap_func_t)( struct region *reg, const struct rectangle *r
 
 static const struct rectangle empty_rect;  /* all-zero rectangle for empty regions */
 
-/* add a rectangle to a region */
-static inline struct rectangle *add_rect( struct region *reg )
+/* check if rect1 entirely contains rect2 */
+static inline int rect_contains( const struct rectangle *rect1, const struct rectangle *rect2 )
+{
+    return (rect1->left <= rect2->left && rect1->top <= rect2->top &&
+            rect1->right >= rect2->right && rect1->bottom >= rect2->bottom);
+}
+
+/* get a rectangle array of at least *size entries, preferably the spare one */
+static struct rectangle *alloc_rects( int *size )
 {
-    if (reg->num_rects >= reg->size)
+    struct rectangle *rects;
+
+    if (spare_rects && spare_size >= *size)
     {
-        struct rectangle *new_rect = realloc( reg->rects, 2 * sizeof(struct rectangle) * reg->size );
-        if (!new_rect)
-        {
-            set_error( STATUS_NO_MEMORY );
-            return NULL;
-        }
-        reg->rects = new_rect;
-        reg->size *= 2;
+        rects = spare_rects;
+        *size = spare_size;
+        spare_rects = NULL;
+        spare_size = 0;
+        return rects;
     }
+    return mem_alloc( *size * sizeof(*rects) );
+}
+
+/* release a rectangle array, keeping it as spare if it is larger than the current one */
+static void release_rects( struct rectangle *rects, int size )
+{
+    if (size > spare_size && size <= MAX_SPARE_RECTS)
+    {
+        free( spare_rects );
+        spare_rects = rects;
+        spare_size = size;
+    }
+    else free( rects );
+}
+
+/* release the rectangle array of a region, reverting to the inline storage */
+static void reset_region_rects( struct region *region )
+{
+    if (region->rects != region->rects_buf) release_rects( region->rects, region->size );
+    region->rects = region->rects_buf;
+    region->size = RGN_DEFAULT_RECTS;
+}
+
+/* grow the rectangle array of a region, preserving the existing rectangles */
+static int grow_region( struct region *reg, int size )
+{
+    struct rectangle *new_rects;
+
+    if (reg->rects == reg->rects_buf)
+    {
+        if (!(new_rects = mem_alloc( size * sizeof(*new_rects) ))) return 0;
+        memcpy( new_rects, reg->rects, reg->num_rects * sizeof(*new_rects) );
+    }
+    else if (!(new_rects = realloc( reg->rects, size * sizeof(*new_rects) )))
+    {
+        set_error( STATUS_NO_MEMORY );
+        return 0;
+    }
+    reg->rects = new_rects;
+    reg->size = size;
+    return 1;
+}
+
+/* add a rectangle to a region */
+static inline struct rectangle *add_rect( struct region *reg )
+{
+    if (reg->num_rects >= reg->size && !grow_region( reg, 2 * reg->size )) return NULL;
     return reg->rects + reg->num_rects++;
 }
 
@@ -220,10 +284,10 @@ static int region_op( struct region *newReg, const struct region *reg1, const st
     const struct rectangle *r2End = r2 + reg2->num_rects;
 
     struct rectangle *new_rects, *old_rects = newReg->rects;
-    int new_size, ret = 0;
+    int new_size, old_size = newReg->size, ret = 0;
 
     new_size = max( reg1->num_rects, reg2->num_rects ) * 2;
-    if (!(new_rects = mem_alloc( new_size * sizeof(*newReg->rects) ))) return 0;
+    if (!(new_rects = alloc_rects( &new_size ))) return 0;
 
     newReg->size = new_size;
     newReg->rects = new_rects;
@@ -321,9 +385,17 @@ static int region_op( struct region *newReg, const struct region *reg1, const st
 
     if (newReg->num_rects != curBand) coalesce_region(newReg, prevBand, curBand);
 
-    if ((newReg->num_rects < (newReg->size / 2)) && (newReg->size > 2))
+    if (newReg->num_rects <= RGN_DEFAULT_RECTS)
+    {
+        /* the sources are no longer needed, so the inline storage can be reused */
+        memcpy( newReg->rects_buf, newReg->rects, newReg->num_rects * sizeof(*newReg->rects) );
+        release_rects( newReg->rects, newReg->size );
+        newReg->rects = newReg->rects_buf;
+        newReg->size = RGN_DEFAULT_RECTS;
+    }
+    else if (newReg->num_rects < newReg->size / 2)
     {
-        new_size = max( newReg->num_rects, RGN_DEFAULT_RECTS );
+        new_size = newReg->num_rects;
         if ((new_rects = realloc( newReg->rects, sizeof(*newReg->rects) * new_size )))
         {
             newReg->rects = new_rects;
@@ -332,7 +404,7 @@ static int region_op( struct region *newReg, const struct region *reg1, const st
     }
     ret = 1;
 done:
-    free( old_rects );
+    if (old_rects != newReg->rects_buf) release_rects( old_rects, old_size );
     return ret;
 }
 
@@ -566,25 +638,19 @@ struct region *create_empty_region(void)
 {
     struct region *region;
 
-    if (!(region = mem_alloc( sizeof(*region) ))) return NULL;
-    if (!(region->rects = mem_alloc( RGN_DEFAULT_RECTS * sizeof(*region->rects) )))
-    {
-        free( region );
-        return NULL;
-    }
+    if (nb_cached_regions) region = cached_regions[--nb_cached_regions];
+    else if (!(region = mem_alloc( sizeof(*region) ))) return NULL;
+
+    region->rects = region->rects_buf;
     region->size = RGN_DEFAULT_RECTS;
     region->num_rects = 0;
-    region->extents.left = 0;
-    region->extents.top = 0;
-    region->extents.right = 0;
-    region->extents.bottom = 0;
+    region->extents = empty_rect;
     return region;
 }
 
 /* create a region from request data */
 struct region *create_region_from_req_data( const void *data, data_size_t size )
 {
-    unsigned int alloc_rects;
     struct region *region;
     const struct rectangle *rects = data;
     int nb_rects = size / sizeof(struct rectangle);
@@ -598,15 +664,13 @@ struct region *create_region_from_req_data( const void *data, data_size_t size )
         return NULL;
     }
 
-    if (!(region = mem_alloc( sizeof(*region) ))) return NULL;
+    if (!(region = create_empty_region())) return NULL;
 
-    alloc_rects = max( nb_rects, RGN_DEFAULT_RECTS );
-    if (!(region->rects = mem_alloc( alloc_rects * sizeof(*region->rects) )))
+    if (nb_rects > RGN_DEFAULT_RECTS && !grow_region( region, nb_rects ))
     {
-        free( region );
+        free_region( region );
         return NULL;
     }
-    region->size = alloc_rects;
     region->num_rects = nb_rects;
     memcpy( region->rects, rects, nb_rects * sizeof(*rects) );
     set_region_extents( region );
@@ -616,8 +680,9 @@ struct region *create_region_from_req_data( const void *data, data_size_t size )
 /* free a region */
 void free_region( struct region *region )
 {
-    free( region->rects );
-    free( region );
+    reset_region_rects( region );
+    if (nb_cached_regions < MAX_CACHED_REGIONS) cached_regions[nb_cached_regions++] = region;
+    else free( region );
 }
 
 /* set region to a simple rectangle */
@@ -654,26 +719,28 @@ struct rectangle *get_region_data( const struct region *region, data_size_t max_
 /* retrieve the region data for sending to the client and free the region at the same time */
 struct rectangle *get_region_data_and_free( struct region *region, data_size_t max_size, data_size_t *total_size )
 {
-    struct rectangle *ret = region->rects;
+    struct rectangle *ret = NULL;
 
     if (!(*total_size = region->num_rects * sizeof(struct rectangle)))
     {
         /* return a single empty rect for empty regions */
         *total_size = sizeof(empty_rect);
-        if (max_size >= sizeof(empty_rect))
+        if (max_size >= sizeof(empty_rect)) ret = memdup( &empty_rect, sizeof(empty_rect) );
+    }
+    else if (max_size >= *total_size)
+    {
+        if (region->rects == region->rects_buf) ret = memdup( region->rects, *total_size );
+        else
         {
-            ret = memdup( &empty_rect, sizeof(empty_rect) );
-            free( region->rects );
+            /* hand over the rectangle array to the caller */
+            ret = region->rects;
+            region->rects = region->rects_buf;
+            region->size = RGN_DEFAULT_RECTS;
         }
     }
 
-    if (max_size < *total_size)
-    {
-        free( region->rects );
-        set_error( STATUS_BUFFER_OVERFLOW );
-        ret = NULL;
-    }
-    free( region );
+    if (max_size < *total_size) set_error( STATUS_BUFFER_OVERFLOW );
+    free_region( region );
     return ret;
 }
 
@@ -760,14 +827,8 @@ struct region *copy_region( struct region *dst, const struct region *src )
 
     if (dst->size < src->num_rects)
     {
-        struct rectangle *rect = realloc( dst->rects, src->num_rects * sizeof(*rect) );
-        if (!rect)
-        {
-            set_error( STATUS_NO_MEMORY );
-            return NULL;
-        }
-        dst->rects = rect;
-        dst->size = src->num_rects;
+        dst->num_rects = 0;  /* no need to preserve the current contents */
+        if (!grow_region( dst, src->num_rects )) return NULL;
     }
     dst->num_rects = src->num_rects;
     dst->extents = src->extents;
@@ -788,6 +849,21 @@ struct region *intersect_region( struct region *dst, const struct region *src1,
         dst->extents.bottom = 0;
         return dst;
     }
+
+    /* fast paths for rectangular regions, which are by far the most common case */
+    if (src1->num_rects == 1 && src2->num_rects == 1)
+    {
+        struct rectangle rect;
+
+        intersect_rect( &rect, &src1->extents, &src2->extents );
+        set_region_rect( dst, &rect );
+        return dst;
+    }
+    if (src1->num_rects == 1 && rect_contains( &src1->extents, &src2->extents ))
+        return copy_region( dst, src2 );
+    if (src2->num_rects == 1 && rect_contains( &src2->extents, &src1->extents ))
+        return copy_region( dst, src1 );
+
     if (!region_op( dst, src1, src2, intersect_overlapping, NULL, NULL )) return NULL;
     set_region_extents( dst );
     return dst;
@@ -800,6 +876,12 @@ struct region *subtract_region( struct region *dst, const struct region *src1,
     if (!src1->num_rects || !src2->num_rects || !EXTENTCHECK(&src1->extents, &src2->extents))
         return copy_region( dst, src1 );
 
+    if (src2->num_rects == 1 && rect_contains( &src2->extents, &src1->extents ))
+    {
+        set_region_rect( dst, &empty_rect );
+        return dst;
+    }
+
     if (!region_op( dst, src1, src2, subtract_overlapping,
                     subtract_non_overlapping, NULL )) return NULL;
     set_region_extents( dst );
@@ -814,18 +896,10 @@ struct region *union_region( struct region *dst, const struct region *src1,
     if (!src1->num_rects) return copy_region( dst, src2 );
     if (!src2->num_rects) return copy_region( dst, src1 );
 
-    if ((src1->num_rects == 1) &&
-        (src1->extents.left <= src2->extents.left) &&
-        (src1->extents.top <= src2->extents.top) &&
-        (src1->extents.right >= src2->extents.right) &&
-        (src1->extents.bottom >= src2->extents.bottom))
+    if (src1->num_rects == 1 && rect_contains( &src1->extents, &src2->extents ))
         return copy_region( dst, src1 );
 
-    if ((src2->num_rects == 1) &&
-        (src2->extents.left <= src1->extents.left) &&
-        (src2->extents.top <= src1->extents.top) &&
-        (src2->extents.right >= src1->extents.right) &&
-        (src2->extents.bottom >= src1->extents.bottom))
+    if (src2->num_rects == 1 && rect_contains( &src2->extents, &src1->extents ))
         return copy_region( dst, src2 );
 
     if (!region_op( dst, src1, src2, union_overlapping,
@@ -72,6 +72,9 @@ struct window
     struct rectangle client_rect;     /* client rectangle (relative to parent client area) */
     struct region   *win_region;      /* region for shaped windows (relative to window rect) */
     struct region   *update_region;   /* update region (relative to window rect) */
+    struct region   *vis_cache;       /* cached visible region (relative to window rect) */
+    unsigned int     vis_flags;       /* DCX flags used to compute the cached visible region */
+    unsigned int     vis_serial;      /* layout serial at the time the cache was computed */
     unsigned int     style;           /* window style */
     unsigned int     ex_style;        /* window extended style */
     lparam_t         id;              /* window id */
@@ -147,6 +150,10 @@ struct user_handle_array
 
 static const struct rectangle empty_rect;
 
+/* serial number of the window layout, incremented every time a change of z-order, */
+/* position, style or shape could affect the visible region of any window */
+static unsigned int vis_region_serial = 1;
+
 /* magic HWND_TOP etc. pointers */
 #define WINPTR_TOP       ((struct window *)1L)
 #define WINPTR_BOTTOM    ((struct window *)2L)
@@ -174,6 +181,7 @@ static void window_destroy( struct object *obj )
 
     if (win->win_region) free_region( win->win_region );
     if (win->update_region) free_region( win->update_region );
+    if (win->vis_cache) free_region( win->vis_cache );
     if (win->class) release_class( win->class );
     free( win->text );
 
@@ -184,6 +192,12 @@ static void window_destroy( struct object *obj )
     }
 }
 
+/* mark all the cached visible regions as stale */
+static inline void invalidate_visible_regions(void)
+{
+    if (!++vis_region_serial) vis_region_serial = 1;
+}
+
 /* retrieve a pointer to a window from its handle */
 static inline struct window *get_window( user_handle_t handle )
 {
@@ -395,6 +409,7 @@ static int link_window( struct window *win, struct window *previous )
     }
 
     win->is_linked = 1;
+    invalidate_visible_regions();
     return old_prev != win->entry.prev;
 }
 
@@ -435,6 +450,7 @@ static int set_parent_window( struct window *win, struct window *parent )
         list_add_head( &win->parent->unlinked, &win->entry );
         win->is_linked = 0;
         win->is_orphan = 1;
+        invalidate_visible_regions();
     }
     return 1;
 }
@@ -645,6 +661,9 @@ static struct window *create_window( struct window *parent, struct window *owner
     win->atom           = atom;
     win->win_region     = NULL;
     win->update_region  = NULL;
+    win->vis_cache      = NULL;
+    win->vis_flags      = 0;
+    win->vis_serial     = 0;
     win->style          = 0;
     win->ex_style       = 0;
     win->id             = 0;
@@ -1229,7 +1248,7 @@ static inline struct window *get_top_clipping_window( struct window *win )
 
 
 /* compute the visible region of a window, in window coordinates */
-static struct region *get_visible_region( struct window *win, unsigned int flags )
+static struct region *compute_visible_region( struct window *win, unsigned int flags )
 {
     struct region *tmp = NULL, *region;
     int offset_x, offset_y;
@@ -1308,6 +1327,32 @@ error:
 }
 
 
+/* get the visible region of a window, in window coordinates, using the cached region if still valid */
+static struct region *get_visible_region( struct window *win, unsigned int flags )
+{
+    struct region *region;
+
+    flags &= DCX_PARENTCLIP | DCX_WINDOW | DCX_CLIPCHILDREN;
+
+    if (win->vis_cache && win->vis_serial == vis_region_serial && win->vis_flags == flags)
+    {
+        if (!(region = create_empty_region())) return NULL;
+        return copy_region( region, win->vis_cache );
+    }
+
+    if (!(region = compute_visible_region( win, flags ))) return NULL;
+
+    if (!win->vis_cache) win->vis_cache = create_empty_region();
+    if (win->vis_cache && copy_region( win->vis_cache, region ))
+    {
+        win->vis_flags  = flags;
+        win->vis_serial = vis_region_serial;
+    }
+    else win->vis_serial = 0;
+    return region;
+}
+
+
 /* clip all children with a custom pixel format out of the visible region */
 static struct region *clip_pixel_format_children( struct window *parent, struct region *parent_clip,
                                                   struct region *region, int offset_x, int offset_y )
@@ -1922,6 +1967,7 @@ static void set_window_pos( struct window *win, struct window *previous,
     win->visible_rect = *visible_rect;
     win->surface_rect = *surface_rect;
     win->client_rect  = *client_rect;
+    invalidate_visible_regions();
     if (!(swp_flags & SWP_NOZORDER) && win->parent) zorder_changed |= link_window( win, previous );
     if (swp_flags & SWP_SHOWWINDOW) win->style |= WS_VISIBLE;
     else if (swp_flags & SWP_HIDEWINDOW) win->style &= ~WS_VISIBLE;
@@ -2080,6 +2126,7 @@ static void set_window_region( struct window *win, struct region *region, int re
 
     if (win->win_region) free_region( win->win_region );
     win->win_region = region;
+    invalidate_visible_regions();
 
     /* expose anything revealed by the change */
     if (old_vis_rgn && ((exposed_rgn = expose_window( win, &win->window_rect, old_vis_rgn, 0 ))))
@@ -2105,6 +2152,7 @@ void free_window_handle( struct window *win )
     {
         struct region *vis_rgn = get_visible_region( win, DCX_WINDOW );
         win->style &= ~WS_VISIBLE;
+        invalidate_visible_regions();
         if (vis_rgn)
         {
             struct region *exposed_rgn = expose_window( win, &win->window_rect, vis_rgn, 0 );
@@ -2379,6 +2427,7 @@ DECL_HANDLER(set_window_info)
         else win->ex_style = (req->ex_style & ~WS_EX_TOPMOST) | (win->ex_style & WS_EX_TOPMOST);
         if (!(win->ex_style & WS_EX_LAYERED)) win->is_layered = 0;
     }
+    if (req->flags & (SET_WIN_STYLE | SET_WIN_EXSTYLE)) invalidate_visible_regions();
     if (req->flags & SET_WIN_ID) win->id = req->extra_value;
     if (req->flags & SET_WIN_INSTANCE) win->instance = req->instance;
     if (req->flags & SET_WIN_UNICODE) win->is_unicode = req->is_unicode;
@@ -2960,6 +3009,7 @@ DECL_HANDLER(update_window_zorder)
         {
             list_remove( &win->entry );
             list_add_before( &ptr->entry, &win->entry );
+            invalidate_visible_regions();
         }
         break;
     }